@@ -0,0 +1,13 @@
+// Arithmetic only, with the light header, see c10/benchmark/compile_time/run.sh
+#include <c10/util/complex_core.h>
+
+c10::complex<float> f(c10::complex<float> a, c10::complex<float> b) {
+  return a * b + a / b + c10::polar(1.0f, 2.0f);
+}
+
+c10::complex<double> g(c10::complex<double> a, c10::complex<double> b) {
+  return a * b - std::conj(a / b) * std::abs(a);
+}
+
+constexpr c10::complex<float> h = c10::complex<float>(1, 2) * c10::complex<float>(3, 4);
+static_assert(h.real() == -5 && h.imag() == 10, "");
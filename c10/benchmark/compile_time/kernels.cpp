@@ -0,0 +1,44 @@
+// Uses one function of each batched kernel header, so that building it without
+// C10_COMPLEX_EXTERN_TEMPLATES instantiates all of them, see c10/benchmark/compile_time/run.sh
+#include <c10/util/complex.h>
+#include <c10/util/complex_correlate.h>
+#include <c10/util/complex_division.h>
+#include <c10/util/complex_fft.h>
+#include <c10/util/complex_linalg.h>
+#include <c10/util/complex_poly.h>
+#include <c10/util/complex_pow.h>
+#include <c10/util/complex_random.h>
+#include <c10/util/complex_scan.h>
+#include <c10/util/complex_select.h>
+#include <c10/util/complex_stats.h>
+#include <c10/util/complex_stft.h>
+#include <iostream>
+
+template<typename T>
+void use(c10::complex<T>* x, c10::complex<T>* y, int64_t n) {
+  c10::randn(x, n, 1);
+  c10::cumsum(x, y, n);
+  c10::cumprod(x, y, n);
+  c10::div(x, x[0], y, n);
+  c10::pow(x, 3, y, n);
+  c10::pow(x, T(0.5), y, n);
+  c10::lu_solve(x, y, 4, 1, 1);
+  c10::qr_solve(x, y, 4, 4, 1, 1);
+  c10::cholesky_solve(x, y, 4, 1, 1);
+  c10::fft_plan<T> plan(64);
+  plan.execute(x, y);
+  c10::stft<T> s(c10::hann_window<T>(64), 16);
+  s.forward(x, n, y);
+  int64_t idx[8];
+  c10::topk_abs(x, n, 8, idx);
+  c10::polyval_estrin(x, 8, y, y, n);
+  c10::roots(x, 4, 1, y);
+  c10::correlator<T> correlator(x, 1, 32);
+  correlator.correlate(x, n, y);
+  c10::moments<T> m;
+  m.update(x, n);
+  std::cout << std::exp(x[0]) << std::log(x[1]) << std::pow(x[0], x[1]) << m.mean() << std::endl;
+}
+
+template void use<float>(c10::complex<float>*, c10::complex<float>*, int64_t);
+template void use<double>(c10::complex<double>*, c10::complex<double>*, int64_t);
@@ -0,0 +1,48 @@
+#!/usr/bin/env bash
+# Compile time of the header split and of the extern template library.
+#
+# Prints the median wall time of compiling (-c, without linking) each translation unit of this
+# directory, at -O0 and -O2:
+# - arithmetic_core.cpp vs arithmetic_full.cpp: the same arithmetic with c10/util/complex_core.h
+#   and with c10/util/complex.h, i.e. what a TU that only does arithmetic saves by including the
+#   core header.
+# - kernels.cpp with and without -DC10_COMPLEX_EXTERN_TEMPLATES: what a TU that calls the batched
+#   kernels saves by linking against c10/util/complex.cpp instead of instantiating them.
+# - c10/util/complex.cpp: the one-time cost of building the library.
+#
+# Usage, from the root of the repository: c10/benchmark/compile_time/run.sh [runs]
+# The compiler is $CXX, g++ by default. runs is the number of compilations per measurement, 5 by
+# default.
+
+set -euo pipefail
+
+CXX=${CXX:-g++}
+RUNS=${1:-5}
+DIR=c10/benchmark/compile_time
+
+if [ ! -f "$DIR/run.sh" ]; then
+  echo "run.sh must be run from the root of the repository" >&2
+  exit 1
+fi
+
+# median of $RUNS compilations, in seconds
+measure() {
+  local times=()
+  for _ in $(seq "$RUNS"); do
+    local start end
+    start=$(date +%s%N)
+    "$CXX" -std=c++14 -pthread -I. "$@" -o /dev/null
+    end=$(date +%s%N)
+    times+=($((end - start)))
+  done
+  printf '%s\n' "${times[@]}" | sort -n | awk '{ t[NR] = $1 } END { printf "%.3f", t[int((NR + 1) / 2)] / 1e9 }'
+}
+
+echo "$CXX, median of $RUNS runs, seconds"
+for opt in -O0 -O2; do
+  echo "$opt arithmetic: complex.h $(measure "$opt" -c $DIR/arithmetic_full.cpp)" \
+       "complex_core.h $(measure "$opt" -c $DIR/arithmetic_core.cpp)"
+  echo "$opt kernels: instantiated $(measure "$opt" -c $DIR/kernels.cpp)" \
+       "extern templates $(measure "$opt" -DC10_COMPLEX_EXTERN_TEMPLATES -c $DIR/kernels.cpp)"
+  echo "$opt library: complex.cpp $(measure "$opt" -DC10_COMPLEX_EXTERN_TEMPLATES -c c10/util/complex.cpp)"
+done
@@ -0,0 +1,191 @@
+// The instrumentation is a compile-time switch, so it is tested in its own translation unit.
+// complex_test.cpp is also built with -DC10_COMPLEX_INSTRUMENTATION in CI, to check that the
+// operators stay constexpr.
+#define C10_COMPLEX_INSTRUMENTATION
+#include <c10/util/complex.h>
+#include <c10/util/complex_division.h>
+#include <c10/util/complex_scan.h>
+#include <c10/util/parallel.h>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <vector>
+
+// gtest mock
+#include <cassert>
+#define ASSERT_EQ(a, b) assert((a) == (b))
+#define ASSERT_LT(a, b) assert((a) < (b))
+#define TEST(a, b) void a##_##b()
+
+namespace instrumentation = c10::instrumentation;
+
+namespace {
+
+uint64_t count(const instrumentation::counters& c, instrumentation::op kind) {
+  return c.ops[static_cast<int>(kind)];
+}
+
+const instrumentation::kernel_stats* find_kernel(const std::vector<instrumentation::kernel_stats>& stats, const char* name) {
+  for (const auto& s : stats) {
+    if (s.name == name) {
+      return &s;
+    }
+  }
+  return nullptr;
+}
+
+int handler_calls = 0;
+
+void count_handler_calls(const instrumentation::nonfinite_origin&) {
+  handler_calls++;
+}
+
+} // namespace
+
+TEST(TestInstrumentation, counters) {
+  instrumentation::reset_counters();
+  c10::complex<double> x(1, 2), y(3, 4);
+  c10::complex<double> z = x * y + x / y - 2.0 * x;
+  (void)z;
+  auto c = instrumentation::get_thread_counters();
+  ASSERT_EQ(count(c, instrumentation::op::multiply), 2);
+  ASSERT_EQ(count(c, instrumentation::op::divide), 1);
+  ASSERT_EQ(count(c, instrumentation::op::add), 1);
+  ASSERT_EQ(count(c, instrumentation::op::subtract), 1);
+  ASSERT_EQ(c.flops, 6 + 2 + 9 + 2 + 2);
+
+  // constant evaluation is not counted
+  instrumentation::reset_counters();
+  constexpr c10::complex<double> w = c10::complex<double>(1, 2) * c10::complex<double>(3, 4);
+  static_assert(w.real() == -5 && w.imag() == 10, "");
+  ASSERT_EQ(instrumentation::get_thread_counters().flops, 0);
+
+  // the counts of the workers of parallel_for are kept after they exit
+  instrumentation::reset_counters();
+  c10::set_num_threads(4);
+  std::vector<c10::complex<float>> data(4000, c10::complex<float>(1, 1));
+  c10::parallel_for(0, 4000, 1000, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      data[i] *= data[i];
+    }
+  });
+  c10::set_num_threads(0);
+  c = instrumentation::get_counters();
+  ASSERT_EQ(count(c, instrumentation::op::multiply), 4000);
+  ASSERT_EQ(c.flops, 6 * 4000);
+  ASSERT_LT(instrumentation::get_thread_counters().flops, c.flops);
+}
+
+TEST(TestInstrumentation, kernels) {
+  instrumentation::reset_counters();
+  instrumentation::reset_kernel_stats();
+  const int64_t n = 10000;
+  std::vector<c10::complex<double>> in(n, c10::complex<double>(1, 1)), out(n);
+  c10::set_num_threads(3);
+  c10::cumsum(in.data(), out.data(), n);
+  c10::cumsum(in.data(), out.data(), n);
+  c10::set_num_threads(0);
+  c10::div(in.data(), c10::complex<double>(2, 0), out.data(), n);
+  auto stats = instrumentation::get_kernel_stats();
+  ASSERT_EQ(stats.size(), 2);
+  ASSERT_EQ(instrumentation::current_kernel(), nullptr);
+  const auto* cumsum = find_kernel(stats, "c10::cumsum");
+  const auto* div = find_kernel(stats, "c10::div");
+  assert(cumsum != nullptr && div != nullptr);
+  ASSERT_EQ(cumsum->calls, 2);
+  ASSERT_EQ(div->calls, 1);
+  // one reciprocal, and one multiplication per element
+  ASSERT_EQ(div->flops, 9 + 6 * n);
+  // at least one addition per element, including the ones done by the workers
+  ASSERT_LT(2 * 2 * n - 1, cumsum->flops);
+  ASSERT_EQ(cumsum->flops + div->flops, instrumentation::get_counters().flops);
+}
+
+TEST(TestInstrumentation, nested_kernels) {
+  // a kernel whose workers run other kernels, which start workers of their own
+  const int64_t chunks = 4, n = 5000;
+  std::vector<c10::complex<double>> in(chunks * n, c10::complex<double>(1, 1)), out(chunks * n);
+  for (int threads : {1, 4}) {
+    instrumentation::reset_counters();
+    instrumentation::reset_kernel_stats();
+    c10::set_num_threads(threads);
+    {
+      C10_COMPLEX_KERNEL("test::outer");
+      c10::parallel_for(0, chunks, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t c = begin; c < end; c++) {
+          c10::cumsum(in.data() + c * n, out.data() + c * n, n);
+          out[c * n] *= out[c * n];
+        }
+      });
+      // a thread not started by parallel_for does not count for the kernel
+      std::thread([] {
+        c10::complex<double> x(1, 2);
+        x *= x;
+      }).join();
+    }
+    c10::set_num_threads(0);
+    auto stats = instrumentation::get_kernel_stats();
+    const auto* outer = find_kernel(stats, "test::outer");
+    const auto* cumsum = find_kernel(stats, "c10::cumsum");
+    assert(outer != nullptr && cumsum != nullptr);
+    ASSERT_EQ(cumsum->calls, chunks);
+    ASSERT_EQ(outer->flops, cumsum->flops + 6 * chunks);
+    ASSERT_EQ(outer->flops + 6, instrumentation::get_counters().flops);
+  }
+}
+
+TEST(TestInstrumentation, nonfinite) {
+  instrumentation::reset_nonfinite();
+  instrumentation::set_nonfinite_handler(count_handler_calls);
+  instrumentation::nonfinite_origin origin;
+  ASSERT_EQ(instrumentation::get_first_nonfinite(origin), false);
+
+  // NaN propagating from the input is not an origin
+  c10::complex<float> nan(std::numeric_limits<float>::quiet_NaN(), 0);
+  c10::complex<float> w = nan * c10::complex<float>(2, 0);
+  ASSERT_EQ(instrumentation::get_first_nonfinite(origin), false);
+
+  // overflow, in a kernel running on a worker thread
+  const int64_t n = 4;
+  std::vector<c10::complex<float>> in(n, c10::complex<float>(1e30f, 0)), out(n);
+  in[2] = c10::complex<float>(1e30f, 1e30f);
+  c10::set_num_threads(4);
+  {
+    C10_COMPLEX_KERNEL("test::square");
+    c10::parallel_for(0, n, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        out[i] = in[i] * in[i];
+      }
+    });
+  }
+  c10::set_num_threads(0);
+  ASSERT_EQ(instrumentation::get_first_nonfinite(origin), true);
+  ASSERT_EQ(origin.kind, instrumentation::op::multiply);
+  ASSERT_EQ(std::strcmp(origin.kernel, "test::square"), 0);
+  ASSERT_EQ(origin.lhs_real, 1e30f);
+  ASSERT_EQ(handler_calls, 1);
+
+  // only the first origin is kept
+  w = c10::complex<float>(1, 0) / c10::complex<float>(0, 0);
+  ASSERT_EQ(instrumentation::get_first_nonfinite(origin), true);
+  ASSERT_EQ(origin.kind, instrumentation::op::multiply);
+  ASSERT_EQ(handler_calls, 1);
+
+  instrumentation::reset_nonfinite();
+  w = c10::complex<float>(1, 0) / c10::complex<float>(0, 0);
+  ASSERT_EQ(instrumentation::get_first_nonfinite(origin), true);
+  ASSERT_EQ(origin.kind, instrumentation::op::divide);
+  ASSERT_EQ(origin.kernel, nullptr);
+  ASSERT_EQ(origin.rhs_real, 0);
+  ASSERT_EQ(handler_calls, 2);
+  instrumentation::set_nonfinite_handler(nullptr);
+  (void)w;
+}
+
+// main
+int main() {
+  TestInstrumentation_counters();
+  TestInstrumentation_kernels();
+  TestInstrumentation_nested_kernels();
+  TestInstrumentation_nonfinite();
+}
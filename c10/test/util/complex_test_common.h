@@ -1,7 +1,24 @@
 #include <c10/util/complex.h>
+#include <c10/util/complex_division.h>
+#include <c10/util/complex_scan.h>
+#include <c10/util/complex_random.h>
+#include <c10/util/complex_linalg.h>
+#include <c10/util/complex_fft.h>
+#include <c10/util/complex_stft.h>
+#include <c10/util/complex_view.h>
+#include <c10/util/complex_fast_math.h>
+#include <c10/util/complex_pow.h>
+#include <c10/util/complex_select.h>
+#include <c10/util/complex_poly.h>
+#include <c10/util/complex_rotation.h>
+#include <c10/util/complex_correlate.h>
+#include <c10/util/complex_stats.h>
 #include <type_traits>
 #include <tuple>
 #include <sstream>
+#include <vector>
+#include <limits>
+#include <algorithm>
 
 #if (defined(__CUDACC__) || defined(__HIPCC__)) && !defined(C10_HOST_DEVICE)
 #define MAYBE_GLOBAL __global__
@@ -500,9 +517,1218 @@ void test_values() {
 
 } // namespace test_std
 
+namespace division {
+
+template<typename scalar_t>
+void test_robust_() {
+  // c^2 + d^2 overflows/underflows, but the quotient is 1
+  scalar_t big = std::numeric_limits<scalar_t>::max() / 4;
+  scalar_t small = std::numeric_limits<scalar_t>::min() * 4;
+  c10::complex<scalar_t> x(big, big);
+  c10::complex<scalar_t> y(small, small);
+  ASSERT_EQ(x / x, c10::complex<scalar_t>(1, 0));
+  ASSERT_EQ(y / y, c10::complex<scalar_t>(1, 0));
+  ASSERT_EQ(c10::div_smith(x, x), c10::complex<scalar_t>(1, 0));
+  ASSERT_LT(std::abs(c10::div_scaled(x, x) - c10::complex<scalar_t>(1, 0)), 1e-6);
+  ASSERT_LT(std::abs(c10::div_scaled(y, y) - c10::complex<scalar_t>(1, 0)), 1e-6);
+  ASSERT_EQ(c10::div_naive(x, x) == c10::complex<scalar_t>(1, 0), false);
+  // |d| > |c| and the ratio c/d underflows to zero
+  c10::complex<scalar_t> z = c10::complex<scalar_t>(small, big) / c10::complex<scalar_t>(small, big / 2);
+  ASSERT_EQ(z, c10::complex<scalar_t>(2, 0));
+}
+
+template<typename scalar_t>
+void test_modes_() {
+  c10::complex<scalar_t> a(-5, 10);
+  c10::complex<scalar_t> b(3, 4);
+  c10::complex<scalar_t> expected(1, 2);
+  ASSERT_EQ(c10::div_naive(a, b), expected);
+  ASSERT_LT(std::abs(c10::div_fast(a, b) - expected), 1e-6);
+  ASSERT_LT(std::abs(c10::div_scaled(a, b) - expected), 1e-6);
+
+  const int64_t n = 37;
+  std::vector<c10::complex<scalar_t>> num(n), den(n), out(n);
+  for (int64_t i = 0; i < n; i++) {
+    num[i] = c10::complex<scalar_t>(i, -2 * i) * b;
+    den[i] = c10::complex<scalar_t>(1, i);
+  }
+  c10::div(num.data(), b, out.data(), n);
+  for (int64_t i = 0; i < n; i++) {
+    ASSERT_LT(std::abs(out[i] - c10::complex<scalar_t>(i, -2 * i)), 1e-5 * (i + 1));
+  }
+  c10::div_fast(num.data(), den.data(), out.data(), n);
+  for (int64_t i = 0; i < n; i++) {
+    ASSERT_LT(std::abs(out[i] - num[i] / den[i]), 1e-5 * std::abs(out[i]) + 1e-6);
+  }
+}
+
+void test_division() {
+  test_robust_<float>();
+  test_robust_<double>();
+  test_modes_<float>();
+  test_modes_<double>();
+}
+
+} // namespace division
+
+namespace scan {
+
+template<typename scalar_t>
+void test_scan_(int64_t n) {
+  c10::complex<scalar_t> empty;
+  c10::cumsum(&empty, &empty, 0);
+  c10::cumprod(&empty, &empty, 0);
+  ASSERT_EQ(empty, c10::complex<scalar_t>());
+
+  std::vector<c10::complex<scalar_t>> in(n), out(n), expected(n);
+  for (int64_t i = 0; i < n; i++) {
+    in[i] = c10::complex<scalar_t>(i % 7, -(i % 5));
+  }
+
+  c10::complex<scalar_t> acc;
+  for (int64_t i = 0; i < n; i++) {
+    acc += in[i];
+    expected[i] = acc;
+  }
+  c10::cumsum(in.data(), out.data(), n);
+  for (int64_t i = 0; i < n; i++) {
+    ASSERT_EQ(out[i], expected[i]);
+  }
+  c10::cumsum_exclusive(in.data(), out.data(), n);
+  ASSERT_EQ(out[0], c10::complex<scalar_t>());
+  for (int64_t i = 1; i < n; i++) {
+    ASSERT_EQ(out[i], expected[i - 1]);
+  }
+
+  // running product of unit phasors
+  const double step = 1e-3;
+  for (int64_t i = 0; i < n; i++) {
+    in[i] = c10::polar(scalar_t(1), scalar_t(step));
+  }
+  c10::cumprod(in.data(), out.data(), n);
+  for (int64_t i = 0; i < n; i++) {
+    ASSERT_LT(std::abs(out[i] - c10::polar(scalar_t(1), scalar_t(step * (i + 1)))), 1e-7 * (i + 1) + 1e-5);
+  }
+  c10::cumprod_exclusive(in.data(), in.data(), n);
+  ASSERT_EQ(in[0], c10::complex<scalar_t>(1, 0));
+  for (int64_t i = 1; i < n; i++) {
+    ASSERT_LT(std::abs(in[i] - out[i - 1]), 1e-7 * (i + 1) + 1e-5);
+  }
+}
+
+void test_scan() {
+  c10::set_num_threads(4);
+  for (int64_t n : {1, 100, 4096, 4097, 50000}) {
+    test_scan_<float>(n);
+    test_scan_<double>(n);
+  }
+  c10::set_num_threads(0);
+}
+
+} // namespace scan
+
+namespace rng {
+
+void test_philox() {
+  // known answers from Random123
+  c10::philox4x32 zero(0, 0, 0);
+  ASSERT_EQ(zero.value[0], 0x6627e8d5u);
+  ASSERT_EQ(zero.value[1], 0xe169c58du);
+  ASSERT_EQ(zero.value[2], 0xbc57ac4cu);
+  ASSERT_EQ(zero.value[3], 0x9b00dbd8u);
+  c10::philox4x32 ones(~uint64_t(0), ~uint64_t(0), ~uint64_t(0));
+  ASSERT_EQ(ones.value[0], 0x408f276du);
+  ASSERT_EQ(ones.value[1], 0x41c83b0eu);
+  ASSERT_EQ(ones.value[2], 0xa20bc7c6u);
+  ASSERT_EQ(ones.value[3], 0x6d5451fdu);
+}
+
+template<typename scalar_t>
+void test_randn_() {
+  const int64_t n = 100001;
+  std::vector<c10::complex<scalar_t>> x(n), y(n);
+  c10::set_num_threads(1);
+  c10::randn(x.data(), n, 42, 0, scalar_t(2));
+  // the stream does not depend on the number of threads or on how it is split
+  c10::set_num_threads(3);
+  c10::randn(y.data(), 777, 42, 0, scalar_t(2));
+  c10::randn(y.data() + 777, n - 777, 42, 777, scalar_t(2));
+  c10::set_num_threads(0);
+  c10::complex<double> mean, pseudo_variance;
+  double variance = 0;
+  for (int64_t i = 0; i < n; i++) {
+    ASSERT_EQ(x[i], y[i]);
+    c10::complex<double> z(x[i]);
+    mean += z;
+    pseudo_variance += z * z;
+    variance += std::norm(z);
+  }
+  ASSERT_LT(std::abs(mean / double(n)), 0.02);
+  ASSERT_LT(std::abs(pseudo_variance / double(n)), 0.05);
+  ASSERT_LT(std::abs(variance / n - 4), 0.05);
+
+  c10::randn(y.data(), n, 43, 0, scalar_t(2));
+  ASSERT_EQ(x[0] != y[0], true);
+}
+
+template<typename scalar_t>
+void test_rand_phasor_() {
+  const int64_t n = 100000;
+  std::vector<c10::complex<scalar_t>> x(n);
+  c10::rand_phasor(x.data(), n, 7);
+  c10::complex<double> mean;
+  for (int64_t i = 0; i < n; i++) {
+    ASSERT_LT(std::abs(std::abs(x[i]) - scalar_t(1)), 1e-6);
+    mean += c10::complex<double>(x[i]);
+  }
+  ASSERT_LT(std::abs(mean / double(n)), 0.02);
+}
+
+void test_random() {
+  test_philox();
+  test_randn_<float>();
+  test_randn_<double>();
+  test_rand_phasor_<float>();
+  test_rand_phasor_<double>();
+}
+
+} // namespace rng
+
+namespace linalg {
+
+// b = a x for every system in the batch
+template<typename scalar_t>
+std::vector<c10::complex<scalar_t>> matmul(
+    const std::vector<c10::complex<scalar_t>>& a, const std::vector<c10::complex<scalar_t>>& x,
+    int64_t rows, int64_t cols, int64_t nrhs, int64_t batch) {
+  std::vector<c10::complex<scalar_t>> b(batch * rows * nrhs);
+  for (int64_t s = 0; s < batch; s++) {
+    for (int64_t i = 0; i < rows; i++) {
+      for (int64_t c = 0; c < nrhs; c++) {
+        for (int64_t k = 0; k < cols; k++) {
+          b[(s * rows + i) * nrhs + c] += a[(s * rows + i) * cols + k] * x[(s * cols + k) * nrhs + c];
+        }
+      }
+    }
+  }
+  return b;
+}
+
+template<typename scalar_t>
+void assert_solution(
+    const std::vector<c10::complex<scalar_t>>& b, const std::vector<c10::complex<scalar_t>>& x,
+    int64_t rows, int64_t cols, int64_t nrhs, int64_t batch, const std::vector<int32_t>& info, double tol) {
+  for (int64_t s = 0; s < batch; s++) {
+    ASSERT_EQ(info[s], 0);
+    for (int64_t i = 0; i < cols * nrhs; i++) {
+      ASSERT_LT(std::abs(b[s * rows * nrhs + i] - x[s * cols * nrhs + i]), tol);
+    }
+  }
+}
+
+template<typename scalar_t>
+void test_solvers_(int64_t n, double tol) {
+  const int64_t nrhs = 2;
+  const int64_t batch = 50;
+  std::vector<c10::complex<scalar_t>> a(batch * n * n), x(batch * n * nrhs);
+  c10::randn(a.data(), a.size(), 1);
+  c10::randn(x.data(), x.size(), 2);
+  std::vector<int32_t> info(batch, -1);
+
+  // LU
+  auto lu = a;
+  auto b = matmul(a, x, n, n, nrhs, batch);
+  c10::lu_solve(lu.data(), b.data(), n, nrhs, batch, info.data());
+  assert_solution(b, x, n, n, nrhs, batch, info, tol);
+
+  // QR, square and overdetermined
+  auto qr = a;
+  b = matmul(a, x, n, n, nrhs, batch);
+  c10::qr_solve(qr.data(), b.data(), n, n, nrhs, batch, info.data());
+  assert_solution(b, x, n, n, nrhs, batch, info, tol);
+  const int64_t rows = n + 3;
+  std::vector<c10::complex<scalar_t>> tall(batch * rows * n);
+  c10::randn(tall.data(), tall.size(), 3);
+  b = matmul(tall, x, rows, n, nrhs, batch);
+  c10::qr_solve(tall.data(), b.data(), rows, n, nrhs, batch, info.data());
+  assert_solution(b, x, rows, n, nrhs, batch, info, tol);
+
+  // Cholesky on a a^H + n I, with garbage in the upper triangle
+  std::vector<c10::complex<scalar_t>> hpd(batch * n * n);
+  for (int64_t s = 0; s < batch; s++) {
+    for (int64_t i = 0; i < n; i++) {
+      for (int64_t j = 0; j < n; j++) {
+        c10::complex<scalar_t> sum(i == j ? scalar_t(n) : scalar_t(0));
+        for (int64_t k = 0; k < n; k++) {
+          sum += a[(s * n + i) * n + k] * std::conj(a[(s * n + j) * n + k]);
+        }
+        hpd[(s * n + i) * n + j] = sum;
+      }
+    }
+  }
+  b = matmul(hpd, x, n, n, nrhs, batch);
+  for (int64_t s = 0; s < batch; s++) {
+    for (int64_t i = 0; i < n; i++) {
+      for (int64_t j = i + 1; j < n; j++) {
+        hpd[(s * n + i) * n + j] = c10::complex<scalar_t>(123, 456);
+      }
+    }
+  }
+  c10::cholesky_solve(hpd.data(), b.data(), n, nrhs, batch, info.data());
+  assert_solution(b, x, n, n, nrhs, batch, info, tol);
+}
+
+template<typename scalar_t>
+void test_singular_() {
+  // second system is singular in its second column, and not positive definite
+  std::vector<c10::complex<scalar_t>> a = {1, 0, 0, 1, 1, 0, 2, 0};
+  std::vector<c10::complex<scalar_t>> b = {1, 2, 3, 4};
+  std::vector<int32_t> info(2, -1);
+  auto copy = a;
+  c10::lu_solve(copy.data(), b.data(), 2, 1, 2, info.data());
+  ASSERT_EQ(info[0], 0);
+  ASSERT_EQ(info[1], 2);
+  copy = a;
+  c10::cholesky_solve(copy.data(), b.data(), 2, 1, 2, info.data());
+  ASSERT_EQ(info[0], 0);
+  ASSERT_EQ(info[1], 2);
+  copy = a;
+  c10::qr_solve(copy.data(), b.data(), 2, 2, 1, 2, info.data());
+  ASSERT_EQ(info[0], 0);
+  ASSERT_EQ(info[1], 2);
+
+  // underdetermined systems are rejected before touching A, B or info
+  copy = a;
+  info.assign(2, -1);
+  bool threw = false;
+  try {
+    c10::qr_solve(copy.data(), b.data(), 1, 2, 1, 2, info.data());
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  ASSERT_EQ(threw, true);
+  ASSERT_EQ(info[0], -1);
+  for (size_t i = 0; i < a.size(); i++) {
+    ASSERT_EQ(copy[i], a[i]);
+  }
+}
+
+void test_linalg() {
+  for (int64_t n : {1, 2, 5, 16}) {
+    test_solvers_<float>(n, 1e-3);
+    test_solvers_<double>(n, 1e-9);
+  }
+  test_singular_<float>();
+  test_singular_<double>();
+}
+
+} // namespace linalg
+
+namespace fft {
+
+template<typename scalar_t>
+std::vector<c10::complex<scalar_t>> dft(const c10::complex<scalar_t>* x, int64_t n) {
+  std::vector<c10::complex<scalar_t>> out(n);
+  for (int64_t k = 0; k < n; k++) {
+    c10::complex<double> sum;
+    for (int64_t j = 0; j < n; j++) {
+      sum += c10::complex<double>(x[j]) * c10::polar(1.0, -2 * PI * ((j * k) % n) / n);
+    }
+    out[k] = c10::complex<scalar_t>(sum);
+  }
+  return out;
+}
+
+template<typename scalar_t>
+void test_fft_(int64_t n, double tol) {
+  std::vector<c10::complex<scalar_t>> x(n), y(n), z(n);
+  c10::randn(x.data(), n, 5);
+  auto expected = dft(x.data(), n);
+  c10::fft_plan<scalar_t> forward(n);
+  c10::fft_plan<scalar_t> inverse(n, true);
+  forward.execute(x.data(), y.data());
+  for (int64_t k = 0; k < n; k++) {
+    ASSERT_LT(std::abs(y[k] - expected[k]), tol);
+  }
+  z = x;
+  forward.execute(z.data(), z.data());
+  inverse.execute(z.data(), z.data());
+  for (int64_t k = 0; k < n; k++) {
+    ASSERT_LT(std::abs(z[k] / scalar_t(n) - x[k]), tol);
+  }
+}
+
+template<typename scalar_t>
+void test_stft_(double tol) {
+  const int64_t n = 64;
+  const int64_t hop = 16;
+  const int64_t length = 1000;
+  std::vector<c10::complex<scalar_t>> x(length);
+  c10::randn(x.data(), length, 9);
+  c10::stft<scalar_t> transform(c10::hann_window<scalar_t>(n), hop);
+  const int64_t frames = transform.num_frames(length);
+  ASSERT_EQ(frames, 59);
+  ASSERT_EQ(transform.num_frames(n - 1), 0);
+
+  // complex input, against a windowed DFT of every frame
+  std::vector<c10::complex<scalar_t>> spectrum(frames * n);
+  transform.forward(x.data(), length, spectrum.data());
+  auto window = c10::hann_window<scalar_t>(n);
+  std::vector<c10::complex<scalar_t>> frame(n);
+  for (int64_t f = 0; f < frames; f++) {
+    for (int64_t j = 0; j < n; j++) {
+      frame[j] = x[f * hop + j] * window[j];
+    }
+    auto expected = dft(frame.data(), n);
+    for (int64_t k = 0; k < n; k++) {
+      ASSERT_LT(std::abs(spectrum[f * n + k] - expected[k]), tol);
+    }
+  }
+  std::vector<scalar_t> magnitude(frames * n), phase(frames * n);
+  transform.magnitude_phase(x.data(), length, magnitude.data(), phase.data());
+  for (int64_t i = 0; i < frames * n; i++) {
+    ASSERT_LT(std::abs(c10::polar(magnitude[i], phase[i]) - spectrum[i]), tol);
+  }
+
+  // overlap-add inverse
+  std::vector<c10::complex<scalar_t>> y(length);
+  transform.inverse(spectrum.data(), frames, y.data());
+  for (int64_t t = 1; t < (frames - 1) * hop + n; t++) {
+    ASSERT_LT(std::abs(y[t] - x[t]), tol);
+  }
+
+  // real input, against the complex transform of the same signal, with an odd number of frames
+  const int64_t real_length = length - 3 * hop;
+  const int64_t real_frames = transform.num_frames(real_length);
+  ASSERT_EQ(real_frames % 2, 0);
+  std::vector<scalar_t> r(length);
+  for (int64_t t = 0; t < length; t++) {
+    r[t] = x[t].real();
+    x[t] = c10::complex<scalar_t>(x[t].real());
+  }
+  for (int64_t len : {real_length, real_length - hop}) {
+    const int64_t bins = transform.onesided_bins();
+    const int64_t count = transform.num_frames(len);
+    std::vector<c10::complex<scalar_t>> onesided(count * bins);
+    transform.forward(r.data(), len, onesided.data());
+    transform.forward(x.data(), len, spectrum.data());
+    transform.magnitude_phase(r.data(), len, magnitude.data(), phase.data());
+    for (int64_t f = 0; f < count; f++) {
+      for (int64_t k = 0; k < bins; k++) {
+        ASSERT_LT(std::abs(onesided[f * bins + k] - spectrum[f * n + k]), tol);
+        ASSERT_LT(std::abs(c10::polar(magnitude[f * bins + k], phase[f * bins + k]) - spectrum[f * n + k]), tol);
+      }
+    }
+  }
+}
+
+void test_windows() {
+  auto hann = c10::hann_window<double>(8);
+  ASSERT_EQ(hann[0], 0.0);
+  ASSERT_LT(std::abs(hann[4] - 1.0), 1e-15);
+  ASSERT_LT(std::abs(hann[2] - 0.5), 1e-15);
+  auto blackman = c10::blackman_window<double>(8);
+  ASSERT_LT(std::abs(blackman[0]), 1e-15);
+  ASSERT_LT(std::abs(blackman[4] - 1.0), 1e-15);
+  auto kaiser = c10::kaiser_window<double>(8, 5.0);
+  ASSERT_LT(std::abs(kaiser[4] - 1.0), 1e-15);
+  ASSERT_LT(std::abs(kaiser[1] - kaiser[7]), 1e-15);
+  // I0(5) = 27.239871823604442
+  ASSERT_LT(std::abs(kaiser[0] - 1.0 / 27.239871823604442), 1e-15);
+}
+
+void test_fft() {
+  for (int64_t n : {1, 2, 8, 64, 256}) {
+    test_fft_<float>(n, 1e-4 * n);
+    test_fft_<double>(n, 1e-12 * n);
+  }
+  test_stft_<float>(1e-3);
+  test_stft_<double>(1e-10);
+  test_windows();
+}
+
+} // namespace fft
+
+namespace view {
+
+template<typename scalar_t>
+void test_view_real_() {
+  std::vector<c10::complex<scalar_t>> x = {{1, 2}, {3, 4}};
+  scalar_t* r = c10::view_as_real(x.data());
+  static_assert(std::is_same<decltype(c10::view_as_real(x.data())), scalar_t*>::value, "");
+  ASSERT_EQ(r[0], scalar_t(1));
+  ASSERT_EQ(r[3], scalar_t(4));
+  r[2] = scalar_t(5);
+  ASSERT_EQ(x[1], c10::complex<scalar_t>(5, 4));
+  const c10::complex<scalar_t>* back = c10::view_as_complex(static_cast<const scalar_t*>(r));
+  ASSERT_EQ(back, x.data());
+}
+
+template<typename scalar_t>
+void test_view_std_() {
+  std::vector<c10::complex<scalar_t>> x = {{1, 2}, {3, 4}};
+  std::complex<scalar_t>* s = c10::view_as_std(x.data());
+  ASSERT_EQ(s[1], std::complex<scalar_t>(3, 4));
+  s[0] *= std::complex<scalar_t>(0, 1);
+  ASSERT_EQ(x[0], c10::complex<scalar_t>(-2, 1));
+
+  alignas(c10::complex<scalar_t>) std::complex<scalar_t> y[2] = {{5, 6}, {7, 8}};
+  c10::complex<scalar_t>* c = c10::view_as_c10(y);
+  ASSERT_EQ(c[1], c10::complex<scalar_t>(7, 8));
+  c[1] = c10::complex<scalar_t>(9, 10);
+  ASSERT_EQ(y[1], std::complex<scalar_t>(9, 10));
+  ASSERT_EQ(c10::view_as_std(static_cast<const c10::complex<scalar_t>*>(c)), y);
+}
+
+void test_view() {
+  test_view_real_<c10::Half>();
+  test_view_real_<float>();
+  test_view_real_<double>();
+  test_view_std_<float>();
+  test_view_std_<double>();
+}
+
+} // namespace view
+
+namespace fast_math {
+
+// normwise relative error in units of FLT_EPSILON
+double error(c10::complex<float> actual, std::complex<double> expected) {
+  return std::abs(std::complex<double>(actual.real(), actual.imag()) - expected) / std::abs(expected) / 1.1920929e-7;
+}
+
+void test_accuracy() {
+  const int64_t n = 20000;
+  std::vector<c10::complex<double>> u(n), v(n);
+  c10::rand_phasor(u.data(), n, 11);
+  c10::rand_phasor(v.data(), n, 12);
+  for (int64_t i = 0; i < n; i++) {
+    // uniform-ish real and imaginary parts in [-1, 1], from the phases
+    const double a = std::arg(u[i]) / PI;
+    const double b = std::arg(v[i]) / PI;
+
+    c10::complex<float> z(float(87 * a), float((i % 2 ? 8192 : 10) * b));
+    std::complex<double> zd(z.real(), z.imag());
+    ASSERT_LT(error(c10::fast::exp(z), std::exp(zd)), 2);
+
+    const double magnitude = i % 4 == 0 ? 1 + 1e-3 * a : std::pow(10.0, 18 * a);
+    z = c10::complex<float>(c10::polar(magnitude, PI * b));
+    zd = std::complex<double>(z.real(), z.imag());
+    ASSERT_LT(error(c10::fast::log(z), std::log(zd)), 3);
+    ASSERT_LT(error(c10::fast::sqrt(z), std::sqrt(zd)), 2);
+
+    z = c10::complex<float>(float((i % 3 ? 3 : 50) * a), float((i % 2 ? 100 : 3) * b));
+    zd = std::complex<double>(z.real(), z.imag());
+    if (std::abs(std::cosh(zd)) >= 0.1) {
+      ASSERT_LT(error(c10::fast::tanh(z), std::tanh(zd)), 4);
+    }
+    const std::complex<double> e = std::exp(-zd);
+    if (std::abs(1.0 + e) >= 0.1 * std::max(1.0, std::abs(e))) {
+      ASSERT_LT(error(c10::fast::sigmoid(z), 1.0 / (1.0 + e)), 8);
+    }
+
+    z = c10::complex<float>(float(2 * a), float(2 * b));
+    c10::complex<float> w(float(2 * b), float(-2 * a));
+    zd = std::complex<double>(z.real(), z.imag());
+    std::complex<double> wd(w.real(), w.imag());
+    ASSERT_LT(error(c10::fast::pow(z, w), std::pow(zd, wd)), 3 * std::max(1.0, std::abs(wd * std::log(zd))));
+  }
+}
+
+void test_special_values() {
+  ASSERT_EQ(c10::fast::exp(c10::complex<float>(0, 0)), c10::complex<float>(1, 0));
+  ASSERT_EQ(c10::fast::exp(c10::complex<float>(-100, 0)), c10::complex<float>(0, 0));
+  ASSERT_EQ(c10::fast::sqrt(c10::complex<float>(0, 0)), c10::complex<float>(0, 0));
+  ASSERT_EQ(c10::fast::sqrt(c10::complex<float>(-4, 0)), c10::complex<float>(0, 2));
+  ASSERT_EQ(c10::fast::sqrt(c10::complex<float>(-4, -0.0f)), c10::complex<float>(0, -2));
+  ASSERT_EQ(c10::fast::log(c10::complex<float>(1, 0)), c10::complex<float>(0, 0));
+  ASSERT_EQ(c10::fast::pow(c10::complex<float>(0, 0), 2.0f), c10::complex<float>(0, 0));
+  ASSERT_EQ(c10::fast::tanh(c10::complex<float>(100, 1)).real(), 1.0f);
+  ASSERT_EQ(c10::fast::sigmoid(c10::complex<float>(0, 0)), c10::complex<float>(0.5f, 0));
+
+  std::vector<c10::complex<float>> x = {{1, 2}, {-3, 0.5f}};
+  std::vector<c10::complex<float>> y(2);
+  c10::fast::tanh(x.data(), y.data(), 2);
+  ASSERT_EQ(y[1], c10::fast::tanh(x[1]));
+  c10::fast::pow(x.data(), c10::complex<float>(0.5f, 1), y.data(), 2);
+  ASSERT_EQ(y[1], c10::fast::pow(x[1], c10::complex<float>(0.5f, 1)));
+  y = x;
+  c10::fast::pow(y.data(), 2.0f, y.data(), 2);
+  ASSERT_EQ(y[0], c10::fast::pow(x[0], 2.0f));
+  ASSERT_EQ(y[1], c10::fast::pow(x[1], 2.0f));
+}
+
+void test_fast_math() {
+  test_accuracy();
+  test_special_values();
+}
+
+} // namespace fast_math
+
+namespace power {
+
+template<typename scalar_t>
+C10_HOST_DEVICE void test_pow_int_() {
+  static_assert(std::pow(c10::complex<scalar_t>(1, 1), 0) == c10::complex<scalar_t>(1, 0), "");
+  static_assert(std::pow(c10::complex<scalar_t>(1, 1), 1) == c10::complex<scalar_t>(1, 1), "");
+  static_assert(std::pow(c10::complex<scalar_t>(1, 1), 2) == c10::complex<scalar_t>(0, 2), "");
+  static_assert(std::pow(c10::complex<scalar_t>(1, 1), 5) == c10::complex<scalar_t>(-4, -4), "");
+  static_assert(std::pow(c10::complex<scalar_t>(0, 2), -2) == c10::complex<scalar_t>(scalar_t(-0.25), 0), "");
+}
+
+MAYBE_GLOBAL void test_pow_int() {
+  test_pow_int_<float>();
+  test_pow_int_<double>();
+}
+
+template<typename scalar_t>
+void test_values_() {
+  const c10::complex<scalar_t> x(scalar_t(0.5), scalar_t(-1.5));
+  const std::complex<double> xd(0.5, -1.5);
+  ASSERT_LT(std::abs(std::exp(x) - c10::complex<scalar_t>(std::exp(xd))), 1e-6);
+  ASSERT_LT(std::abs(std::log(x) - c10::complex<scalar_t>(std::log(xd))), 1e-6);
+  ASSERT_LT(std::abs(std::pow(x, scalar_t(2.5)) - c10::complex<scalar_t>(std::pow(xd, 2.5))), 1e-5);
+  ASSERT_LT(std::abs(std::pow(scalar_t(2.5), x) - c10::complex<scalar_t>(std::pow(2.5, xd))), 1e-5);
+  ASSERT_LT(std::abs(std::pow(x, x) - c10::complex<scalar_t>(std::pow(xd, xd))), 1e-5);
+  ASSERT_EQ(std::pow(c10::complex<scalar_t>(4, 0), scalar_t(0.5)), c10::complex<scalar_t>(2, 0));
+  ASSERT_EQ(std::pow(c10::complex<scalar_t>(), x), c10::complex<scalar_t>());
+  ASSERT_EQ(std::pow(c10::complex<scalar_t>(), scalar_t(2)), c10::complex<scalar_t>());
+  // real exponents of the other precision are promoted, not converted to int
+  const auto half = std::pow(c10::complex<scalar_t>(4, 0), 0.5);
+  static_assert(std::is_same<decltype(half), const c10::complex<double>>::value, "");
+  ASSERT_EQ(half, c10::complex<double>(2, 0));
+  const auto quarter = std::pow(c10::complex<scalar_t>(16, 0), 0.25f);
+  static_assert(std::is_same<decltype(quarter), const c10::complex<scalar_t>>::value, "");
+  ASSERT_EQ(quarter, c10::complex<scalar_t>(2, 0));
+  ASSERT_EQ(std::pow(c10::complex<scalar_t>(0, 2), 2u), c10::complex<scalar_t>(-4, 0));
+  ASSERT_EQ(std::pow(c10::complex<scalar_t>(0, 2), int64_t(-2)), c10::complex<scalar_t>(scalar_t(-0.25), 0));
+}
+
+template<typename scalar_t>
+void test_batched_() {
+  const int64_t n = 1000;
+  std::vector<c10::complex<scalar_t>> x(n), y(n);
+  c10::randn(x.data(), n, 3);
+  for (int exponent : {0, 1, 2, 3, 7, 16, -1, -3}) {
+    c10::pow(x.data(), exponent, y.data(), n);
+    for (int64_t i = 0; i < n; i++) {
+      const std::complex<double> expected = std::pow(std::complex<double>(x[i].real(), x[i].imag()), exponent);
+      ASSERT_LT(std::abs(std::complex<double>(y[i].real(), y[i].imag()) - expected), 1e-5 * std::abs(expected));
+    }
+  }
+  c10::pow(x.data(), scalar_t(0.5), y.data(), n);
+  for (int64_t i = 0; i < n; i++) {
+    ASSERT_EQ(y[i], std::pow(x[i], scalar_t(0.5)));
+  }
+  // a double exponent is converted to the precision of x, not to int
+  c10::pow(x.data(), 0.5, y.data(), n);
+  for (int64_t i = 0; i < n; i++) {
+    ASSERT_EQ(y[i], std::pow(x[i], scalar_t(0.5)));
+  }
+  c10::pow(x.data(), int64_t(3), y.data(), n);
+  for (int64_t i = 0; i < n; i++) {
+    ASSERT_LT(std::abs(y[i] - x[i] * x[i] * x[i]), scalar_t(1e-4) * std::abs(y[i]));
+  }
+  c10::pow(x.data(), c10::complex<scalar_t>(1, 1), y.data(), n);
+  for (int64_t i = 0; i < n; i++) {
+    ASSERT_EQ(y[i], std::pow(x[i], c10::complex<scalar_t>(1, 1)));
+  }
+  // in place
+  y = x;
+  c10::pow(y.data(), 2, y.data(), n);
+  for (int64_t i = 0; i < n; i++) {
+    // not exact, the compiler may contract the products differently with FMA
+    ASSERT_LT(std::abs(y[i] - x[i] * x[i]), scalar_t(1e-4) * std::abs(y[i]));
+  }
+}
+
+void test_pow() {
+  test_values_<float>();
+  test_values_<double>();
+  test_batched_<float>();
+  test_batched_<double>();
+}
+
+} // namespace power
+
+namespace selection {
+
+template<typename scalar_t>
+void test_select_() {
+  const int64_t n = 100000;
+  std::vector<c10::complex<scalar_t>> x(n);
+  c10::randn(x.data(), n, 21);
+  // a duplicate of the peak later in the array, which must lose the tie
+  x[70000] = c10::complex<scalar_t>(30, 40);
+  x[90000] = c10::complex<scalar_t>(-40, 30);
+  x[12345] = c10::complex<scalar_t>(0, 20);
+
+  std::vector<int64_t> order(n);
+  for (int64_t i = 0; i < n; i++) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+    return std::abs(x[a]) > std::abs(x[b]);
+  });
+
+  ASSERT_EQ(c10::argmax_abs(x.data(), n), 70000);
+  ASSERT_EQ(c10::argmax_abs(x.data(), 0), -1);
+  std::vector<c10::complex<scalar_t>> nans(3, c10::complex<scalar_t>(std::numeric_limits<scalar_t>::quiet_NaN(), 0));
+  ASSERT_EQ(c10::argmax_abs(nans.data(), 3), 0);
+  std::vector<int64_t> indices(n);
+  ASSERT_EQ(c10::topk_abs(x.data(), n, 10, indices.data()), 10);
+  for (int64_t i = 0; i < 10; i++) {
+    ASSERT_EQ(indices[i], order[i]);
+  }
+  ASSERT_EQ(indices[2], 12345);
+  ASSERT_EQ(c10::topk_abs(x.data(), 3, 10, indices.data()), 3);
+  // NaN norms inside the first k elements of a chunk are ranked last
+  const scalar_t nan = std::numeric_limits<scalar_t>::quiet_NaN();
+  std::vector<c10::complex<scalar_t>> y(x.begin(), x.begin() + 1000);
+  y[0] = c10::complex<scalar_t>(nan, 0);
+  y[3] = c10::complex<scalar_t>(1, nan);
+  y[500] = c10::complex<scalar_t>(0, 50);
+  ASSERT_EQ(c10::topk_abs(y.data(), 1000, 4, indices.data()), 4);
+  ASSERT_EQ(indices[0], 500);
+  for (int64_t i = 1; i < 4; i++) {
+    ASSERT_LT(indices[i], 1000);
+    assert(!std::isnan(std::norm(y[indices[i]])));
+    ASSERT_EQ(std::norm(y[indices[i]]) <= std::norm(y[indices[i - 1]]), true);
+  }
+  ASSERT_EQ(c10::topk_abs(y.data(), 4, 4, indices.data()), 4);
+  ASSERT_EQ(indices[2], 0);
+  ASSERT_EQ(indices[3], 3);
+
+  const scalar_t threshold = 4;
+  const int64_t count = c10::threshold_abs(x.data(), n, threshold, indices.data());
+  int64_t expected = 0;
+  for (int64_t i = 0; i < n; i++) {
+    if (std::abs(x[i]) > threshold) {
+      ASSERT_LT(expected, count);
+      ASSERT_EQ(indices[expected++], i);
+    }
+  }
+  ASSERT_EQ(count, expected);
+  bool threw = false;
+  try {
+    c10::threshold_abs(x.data(), n, scalar_t(-4), indices.data());
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  ASSERT_EQ(threw, true);
+}
+
+template<typename scalar_t>
+void test_cfar_() {
+  const int64_t n = 70000;
+  const int64_t guard = 2;
+  const int64_t train = 8;
+  const scalar_t scale = 12;
+  std::vector<c10::complex<scalar_t>> x(n);
+  c10::randn(x.data(), n, 22);
+  for (int64_t i : {int64_t(0), int64_t(5), int64_t(32768), int64_t(50000), n - 1}) {
+    x[i] *= scalar_t(10);
+  }
+  std::vector<int64_t> indices(n);
+  const int64_t count = c10::cfar_abs(x.data(), n, guard, train, scale, indices.data());
+  int64_t expected = 0;
+  for (int64_t i = 0; i < n; i++) {
+    double noise = 0;
+    int64_t cells = 0;
+    for (int64_t j = std::max<int64_t>(0, i - guard - train); j <= std::min(n - 1, i + guard + train); j++) {
+      if (std::abs(j - i) > guard) {
+        noise += std::norm(x[j]);
+        cells++;
+      }
+    }
+    if (std::norm(x[i]) > scale * noise / cells) {
+      ASSERT_LT(expected, count);
+      ASSERT_EQ(indices[expected++], i);
+    }
+  }
+  ASSERT_EQ(count, expected);
+  ASSERT_LT(4, count);
+}
+
+void test_select() {
+  c10::set_num_threads(3);
+  test_select_<float>();
+  test_select_<double>();
+  test_cfar_<float>();
+  test_cfar_<double>();
+  c10::set_num_threads(0);
+}
+
+} // namespace selection
+
+namespace poly {
+
+template<typename scalar_t>
+void test_polyval_() {
+  const scalar_t tol = 100 * std::numeric_limits<scalar_t>::epsilon();
+  const int64_t n = 1000;
+  std::vector<c10::complex<scalar_t>> z(n);
+  c10::rand_phasor(z.data(), n, 23);
+  for (int64_t i = 0; i < n; i++) {
+    z[i] *= scalar_t(0.5) + scalar_t(i % 7) / 10;
+  }
+  std::vector<c10::complex<scalar_t>> horner(n), estrin(n);
+  for (int64_t ncoef = 0; ncoef <= 13; ncoef++) {
+    std::vector<c10::complex<scalar_t>> coeffs(ncoef + 1);
+    std::vector<scalar_t> real_coeffs(ncoef + 1);
+    for (int64_t k = 0; k < ncoef; k++) {
+      coeffs[k] = c10::complex<scalar_t>(scalar_t(k + 1) / 4, scalar_t(2 - k) / 3);
+      real_coeffs[k] = coeffs[k].real();
+    }
+    c10::polyval_horner(coeffs.data(), ncoef, z.data(), horner.data(), n);
+    c10::polyval_estrin(coeffs.data(), ncoef, z.data(), estrin.data(), n);
+    for (int64_t i = 0; i < n; i++) {
+      c10::complex<scalar_t> expected, power(1);
+      for (int64_t k = 0; k < ncoef; k++) {
+        expected += coeffs[k] * power;
+        power *= z[i];
+      }
+      const scalar_t scale = std::max(scalar_t(1), std::abs(expected));
+      ASSERT_LT(std::abs(horner[i] - expected), tol * scale);
+      ASSERT_LT(std::abs(estrin[i] - expected), tol * scale);
+    }
+    c10::polyval_horner(real_coeffs.data(), ncoef, z.data(), horner.data(), n);
+    c10::polyval_estrin(real_coeffs.data(), ncoef, z.data(), estrin.data(), n);
+    for (int64_t i = 0; i < n; i++) {
+      ASSERT_LT(std::abs(horner[i] - estrin[i]), tol * std::max(scalar_t(1), std::abs(horner[i])));
+    }
+  }
+}
+
+template<typename scalar_t>
+void test_freqz_() {
+  // moving average of 4 samples, over a one pole filter
+  const scalar_t b[] = {0.25, 0.25, 0.25, 0.25};
+  const scalar_t a[] = {1, -0.5};
+  const int64_t n = 64;
+  std::vector<c10::complex<scalar_t>> h(n);
+  c10::freqz(b, 4, a, 2, h.data(), n);
+  for (int64_t k = 0; k < n; k++) {
+    const scalar_t w = PI * k / n;
+    const c10::complex<scalar_t> z = c10::polar(scalar_t(1), -w);
+    const c10::complex<scalar_t> expected = (scalar_t(0.25) * (scalar_t(1) + z + z * z + z * z * z)) / (scalar_t(1) - scalar_t(0.5) * z);
+    ASSERT_LT(std::abs(h[k] - expected), 10 * std::numeric_limits<scalar_t>::epsilon());
+  }
+  ASSERT_LT(std::abs(h[0] - c10::complex<scalar_t>(2)), 10 * std::numeric_limits<scalar_t>::epsilon());
+}
+
+template<typename scalar_t>
+void test_roots_() {
+  const scalar_t tol = 1000 * std::numeric_limits<scalar_t>::epsilon();
+  const int64_t degree = 6;
+  const int64_t batch = 40;
+  // polynomials built from known distinct roots, monic times a complex scale
+  std::vector<c10::complex<scalar_t>> expected(batch * degree);
+  c10::rand_phasor(expected.data(), batch * degree, 24);
+  std::vector<c10::complex<scalar_t>> coeffs(batch * (degree + 1));
+  for (int64_t b = 0; b < batch; b++) {
+    c10::complex<scalar_t>* r = expected.data() + b * degree;
+    for (int64_t k = 0; k < degree; k++) {
+      r[k] *= scalar_t(0.5) + scalar_t(k) / 4;
+    }
+    c10::complex<scalar_t>* c = coeffs.data() + b * (degree + 1);
+    c[0] = c10::complex<scalar_t>(scalar_t(1), scalar_t(b % 3));
+    for (int64_t k = 0; k < degree; k++) {
+      // multiply by (z - r[k])
+      for (int64_t m = k + 1; m > 0; m--) {
+        c[m] = c[m - 1] - r[k] * c[m];
+      }
+      c[0] = -r[k] * c[0];
+    }
+  }
+  std::vector<c10::complex<scalar_t>> found(batch * degree);
+  std::vector<int32_t> info(batch, -1);
+  c10::roots(coeffs.data(), degree, batch, found.data(), info.data());
+  for (int64_t b = 0; b < batch; b++) {
+    ASSERT_EQ(info[b], 0);
+    for (int64_t k = 0; k < degree; k++) {
+      scalar_t best = std::numeric_limits<scalar_t>::infinity();
+      for (int64_t j = 0; j < degree; j++) {
+        best = std::min(best, std::abs(found[b * degree + j] - expected[b * degree + k]));
+      }
+      ASSERT_LT(best, tol);
+    }
+  }
+
+  // z^3 - 1
+  const c10::complex<scalar_t> cubic[] = {-1, 0, 0, 1};
+  c10::complex<scalar_t> unity[3];
+  c10::roots(cubic, 3, 1, unity);
+  for (int64_t k = 0; k < 3; k++) {
+    ASSERT_LT(std::abs(std::abs(unity[k]) - 1), tol);
+    ASSERT_LT(std::abs(unity[k] * unity[k] * unity[k] - scalar_t(1)), tol);
+  }
+}
+
+void test_poly() {
+  test_polyval_<float>();
+  test_polyval_<double>();
+  test_freqz_<float>();
+  test_freqz_<double>();
+  c10::set_num_threads(3);
+  test_roots_<float>();
+  test_roots_<double>();
+  c10::set_num_threads(0);
+}
+
+} // namespace poly
+
+namespace rotation {
+
+template<typename scalar_t>
+void test_givens_() {
+  using complex_t = c10::complex<scalar_t>;
+  const scalar_t tol = 10 * std::numeric_limits<scalar_t>::epsilon();
+  const int64_t batch = 100;
+  std::vector<complex_t> a(batch), b(batch), r(batch), s(batch);
+  std::vector<scalar_t> c(batch);
+  c10::randn(a.data(), batch, 31);
+  c10::randn(b.data(), batch, 32);
+  a[0] = complex_t();
+  // would overflow |a|^2 + |b|^2
+  a[1] = complex_t(std::numeric_limits<scalar_t>::max() / 4, 0);
+  b[1] = complex_t(0, std::numeric_limits<scalar_t>::max() / 4);
+  r = a;
+  c10::rotg_batch(r.data(), b.data(), c.data(), s.data(), batch);
+  ASSERT_EQ(c[0], scalar_t(0));
+  ASSERT_EQ(s[0], complex_t(1));
+  ASSERT_EQ(r[0], b[0]);
+  ASSERT_LT(std::abs(c[1] - scalar_t(std::sqrt(0.5))), tol);
+  ASSERT_LT(std::abs(r[1].real() / a[1].real() - scalar_t(std::sqrt(2.0))), tol);
+  for (int64_t k = 2; k < batch; k++) {
+    const scalar_t scale = std::abs(r[k]);
+    ASSERT_LT(std::abs(c[k] * c[k] + std::norm(s[k]) - scalar_t(1)), tol);
+    ASSERT_LT(std::abs(c[k] * a[k] + s[k] * b[k] - r[k]), tol * scale);
+    ASSERT_LT(std::abs(c[k] * b[k] - std::conj(s[k]) * a[k]), tol * scale);
+    ASSERT_LT(std::abs(std::arg(r[k]) - std::arg(a[k])), tol * 10);
+  }
+
+  // rotate pairs of rows of length n
+  const int64_t n = 37;
+  std::vector<complex_t> x(batch * n), y(batch * n);
+  c10::randn(x.data(), batch * n, 33);
+  c10::randn(y.data(), batch * n, 34);
+  std::vector<complex_t> x0 = x, y0 = y;
+  c10::set_num_threads(3);
+  c10::rot_batch(x.data(), y.data(), n, c.data(), s.data(), batch);
+  c10::set_num_threads(0);
+  for (int64_t k = 0; k < batch; k++) {
+    for (int64_t i = 0; i < n; i++) {
+      const int64_t j = k * n + i;
+      ASSERT_LT(std::abs(x[j] - (c[k] * x0[j] + s[k] * y0[j])), tol * 10);
+      ASSERT_LT(std::abs(y[j] - (c[k] * y0[j] - std::conj(s[k]) * x0[j])), tol * 10);
+    }
+  }
+}
+
+template<typename scalar_t>
+void test_householder_() {
+  using complex_t = c10::complex<scalar_t>;
+  const scalar_t tol = 100 * std::numeric_limits<scalar_t>::epsilon();
+  const int64_t n = 9;
+  std::vector<complex_t> v(n);
+  c10::randn(v.data(), n, 35);
+  const std::vector<complex_t> x = v;
+  complex_t tau;
+  c10::householder(v[0], v.data() + 1, n, tau);
+  const complex_t beta = v[0];
+  ASSERT_EQ(beta.imag(), scalar_t(0));
+  v[0] = complex_t(1);
+
+  // H^H x = beta e_1, and H is unitary: H^H H y = y for random vectors y
+  std::vector<complex_t> hx = x;
+  c10::apply_householder(v.data(), std::conj(tau), hx.data(), n, 1, n);
+  ASSERT_LT(std::abs(hx[0] - beta), tol);
+  for (int64_t i = 1; i < n; i++) {
+    ASSERT_LT(std::abs(hx[i]), tol);
+  }
+  const int64_t count = 50;
+  const int64_t stride = n + 3;
+  std::vector<complex_t> y(count * stride);
+  c10::randn(y.data(), count * stride, 36);
+  std::vector<complex_t> y0 = y;
+  c10::set_num_threads(3);
+  c10::apply_householder(v.data(), tau, y.data(), n, count, stride);
+  c10::apply_householder(v.data(), std::conj(tau), y.data(), n, count, stride);
+  c10::set_num_threads(0);
+  for (int64_t k = 0; k < count * stride; k++) {
+    ASSERT_LT(std::abs(y[k] - y0[k]), tol);
+  }
+
+  // a real multiple of e_1 needs no reflection
+  std::vector<complex_t> e(n);
+  e[0] = complex_t(3);
+  c10::householder(e[0], e.data() + 1, n, tau);
+  ASSERT_EQ(tau, complex_t());
+  ASSERT_EQ(e[0], complex_t(3));
+}
+
+void test_rotation() {
+  test_givens_<float>();
+  test_givens_<double>();
+  test_householder_<float>();
+  test_householder_<double>();
+}
+
+} // namespace rotation
+
+namespace correlation {
+
+template<typename scalar_t>
+void test_correlator_(int64_t m, c10::correlation_method method) {
+  using complex_t = c10::complex<scalar_t>;
+  const scalar_t tol = 100 * std::numeric_limits<scalar_t>::epsilon();
+  const int64_t num_templates = 5;
+  std::vector<complex_t> templates(num_templates * m);
+  c10::randn(templates.data(), num_templates * m, 41);
+  const c10::correlator<scalar_t> bank(templates.data(), num_templates, m, method);
+  ASSERT_EQ(bank.method() != c10::correlation_method::automatic, true);
+  // shorter than the template, one partial segment, several segments
+  for (int64_t length : {m - 1, m + 10, 3 * bank.fft_size() + 5 * m + 7}) {
+    std::vector<complex_t> x(std::max<int64_t>(length, 0));
+    c10::randn(x.data(), length, 42);
+    const int64_t outputs = bank.output_length(length);
+    ASSERT_EQ(outputs, std::max<int64_t>(0, length - m + 1));
+    std::vector<complex_t> out(num_templates * outputs);
+    c10::set_num_threads(3);
+    bank.correlate(x.data(), length, out.data());
+    c10::set_num_threads(0);
+    for (int64_t t = 0; t < num_templates; t++) {
+      const complex_t* h = templates.data() + t * m;
+      for (int64_t i = 0; i < outputs; i++) {
+        complex_t expected;
+        for (int64_t j = 0; j < m; j++) {
+          expected += std::conj(h[j]) * x[i + j];
+        }
+        ASSERT_LT(std::abs(out[t * outputs + i] - expected), tol * m);
+      }
+    }
+  }
+}
+
+template<typename scalar_t>
+void test_correlator() {
+  using complex_t = c10::complex<scalar_t>;
+  for (int64_t m : {1, 7, 32, 100}) {
+    test_correlator_<scalar_t>(m, c10::correlation_method::direct);
+    test_correlator_<scalar_t>(m, c10::correlation_method::fft);
+  }
+  test_correlator_<scalar_t>(5, c10::correlation_method::automatic);
+
+  // short templates are correlated directly, long ones through FFTs
+  std::vector<complex_t> h(1000, complex_t(1));
+  ASSERT_EQ(c10::correlator<scalar_t>(h.data(), 1, 8).method() == c10::correlation_method::direct, true);
+  const c10::correlator<scalar_t> long_bank(h.data(), 1, 1000);
+  ASSERT_EQ(long_bank.method() == c10::correlation_method::fft, true);
+  ASSERT_EQ(long_bank.fft_size() >= 4 * 1000, true);
+
+  // the matched filter peaks where the template was inserted, with the energy of the template
+  const int64_t m = 64;
+  std::vector<complex_t> preamble(m);
+  c10::randn(preamble.data(), m, 43);
+  std::vector<complex_t> x(5000);
+  c10::randn(x.data(), 5000, 44, 0, scalar_t(0.01));
+  const int64_t position = 1234;
+  scalar_t energy = 0;
+  for (int64_t j = 0; j < m; j++) {
+    x[position + j] += preamble[j];
+    energy += std::norm(preamble[j]);
+  }
+  const c10::correlator<scalar_t> detector(preamble.data(), 1, m);
+  std::vector<complex_t> out(detector.output_length(5000));
+  detector.correlate(x.data(), 5000, out.data());
+  int64_t peak = 0;
+  for (int64_t i = 1; i < static_cast<int64_t>(out.size()); i++) {
+    if (std::abs(out[i]) > std::abs(out[peak])) {
+      peak = i;
+    }
+  }
+  ASSERT_EQ(peak, position);
+  ASSERT_LT(std::abs(out[peak].real() - energy), energy * scalar_t(0.1));
+}
+
+void test_correlate() {
+  test_correlator<float>();
+  test_correlator<double>();
+}
+
+} // namespace correlation
+
+namespace stats {
+
+template<typename scalar_t>
+void test_moments_() {
+  using complex_t = c10::complex<scalar_t>;
+  // sums of thousands of terms per lane
+  const scalar_t tol = 1000 * std::numeric_limits<scalar_t>::epsilon();
+  const int64_t n = 10007;
+  std::vector<complex_t> x(n), y(n);
+  c10::randn(x.data(), n, 51);
+  c10::randn(y.data(), n, 52);
+  // a large offset, which E|x|^2 - |E x|^2 would cancel, and correlated real and imaginary parts
+  for (int64_t i = 0; i < n; i++) {
+    x[i] = complex_t(x[i].real() + 1000, x[i].real() * scalar_t(0.5) + x[i].imag() - 2000);
+    y[i] = x[i] * complex_t(0, 2) + y[i];
+  }
+  std::complex<double> mean_x, mean_y;
+  for (int64_t i = 0; i < n; i++) {
+    mean_x += std::complex<double>(x[i].real(), x[i].imag());
+    mean_y += std::complex<double>(y[i].real(), y[i].imag());
+  }
+  mean_x /= double(n);
+  mean_y /= double(n);
+  double variance = 0;
+  std::complex<double> pseudo, covariance, pseudo_covariance;
+  for (int64_t i = 0; i < n; i++) {
+    const std::complex<double> a = std::complex<double>(x[i].real(), x[i].imag()) - mean_x;
+    const std::complex<double> b = std::complex<double>(y[i].real(), y[i].imag()) - mean_y;
+    variance += std::norm(a);
+    pseudo += a * a;
+    covariance += a * std::conj(b);
+    pseudo_covariance += a * b;
+  }
+  variance /= double(n);
+  pseudo /= double(n);
+  covariance /= double(n);
+  pseudo_covariance /= double(n);
+
+  c10::set_num_threads(3);
+  c10::moments<scalar_t> m;
+  m.update(x.data(), n);
+  c10::set_num_threads(1);
+  c10::moments<scalar_t> serial;
+  serial.update(x.data(), n);
+  c10::set_num_threads(0);
+  ASSERT_EQ(m.count(), n);
+  ASSERT_EQ(m.mean(), serial.mean());
+  ASSERT_EQ(m.variance(), serial.variance());
+  ASSERT_LT(std::abs(std::complex<double>(m.mean().real(), m.mean().imag()) - mean_x), tol * std::abs(mean_x));
+  ASSERT_LT(std::abs(m.variance() - variance), tol * variance);
+  ASSERT_LT(std::abs(m.variance(1) - variance * n / (n - 1)), tol * variance);
+  ASSERT_LT(std::abs(std::complex<double>(m.pseudo_variance().real(), m.pseudo_variance().imag()) - pseudo), tol * variance);
+  ASSERT_LT(std::abs(m.power() - (variance + std::norm(mean_x))), tol * std::norm(mean_x));
+
+  // one sample at a time, and buffers of several sizes merged
+  c10::moments<scalar_t> one, merged, part;
+  for (int64_t i = 0; i < n; i++) {
+    one.update(x[i]);
+  }
+  part.update(x.data(), 5000);
+  merged.merge(part);
+  part = c10::moments<scalar_t>();
+  part.update(x.data() + 5000, 1);
+  part.update(x.data() + 5001, n - 5001);
+  merged.merge(part);
+  merged.merge(c10::moments<scalar_t>());
+  for (const auto& r : {one, merged}) {
+    ASSERT_EQ(r.count(), n);
+    ASSERT_LT(std::abs(r.mean() - m.mean()), tol * std::abs(m.mean()));
+    ASSERT_LT(std::abs(r.variance() - m.variance()), 10 * tol * variance);
+    ASSERT_LT(std::abs(r.pseudo_variance() - m.pseudo_variance()), 10 * tol * variance);
+  }
+
+  c10::cross_moments<scalar_t> c, c_one;
+  c.update(x.data(), y.data(), 3000);
+  c_one.update(x.data() + 3000, y.data() + 3000, n - 3000);
+  c.merge(c_one);
+  c_one = c10::cross_moments<scalar_t>();
+  for (int64_t i = 0; i < n; i++) {
+    c_one.update(x[i], y[i]);
+  }
+  for (const auto& r : {c, c_one}) {
+    ASSERT_EQ(r.count(), n);
+    ASSERT_LT(std::abs(std::complex<double>(r.mean_y().real(), r.mean_y().imag()) - mean_y), tol * std::abs(mean_y));
+    ASSERT_LT(std::abs(std::complex<double>(r.covariance().real(), r.covariance().imag()) - covariance), 10 * tol * std::abs(covariance));
+    ASSERT_LT(std::abs(std::complex<double>(r.pseudo_covariance().real(), r.pseudo_covariance().imag()) - pseudo_covariance),
+              10 * tol * std::abs(covariance));
+  }
+}
+
+template<typename scalar_t>
+void test_histogram_() {
+  using complex_t = c10::complex<scalar_t>;
+  const int64_t n = 100000;
+  const int64_t bins = 37;
+  std::vector<complex_t> x(n);
+  c10::randn(x.data(), n, 53);
+  x[0] = complex_t(-1, 0);
+  x[1] = complex_t();
+  x[2] = complex_t(std::numeric_limits<scalar_t>::quiet_NaN(), 0);
+  x[3] = complex_t(100, 0);
+  x[4] = complex_t(scalar_t(1e-30), scalar_t(-1e-30));
+
+  const scalar_t max_magnitude = 3;
+  std::vector<int64_t> expected_magnitude(bins), expected_phase(bins);
+  int64_t discarded_magnitude = 0;
+  for (int64_t i = 0; i < n; i++) {
+    const scalar_t magnitude = std::abs(x[i]);
+    if (magnitude < max_magnitude) {
+      expected_magnitude[static_cast<int64_t>(magnitude / max_magnitude * bins)]++;
+    } else {
+      discarded_magnitude++;
+    }
+    if (i != 2) {
+      const scalar_t phase = std::arg(x[i]);
+      expected_phase[std::min<int64_t>(bins - 1, static_cast<int64_t>((phase + PI) / (2 * PI) * bins))]++;
+    }
+  }
+
+  c10::set_num_threads(3);
+  c10::magnitude_histogram<scalar_t> magnitudes(bins, max_magnitude);
+  magnitudes.update(x.data(), 60000);
+  c10::magnitude_histogram<scalar_t> rest(bins, max_magnitude);
+  rest.update(x.data() + 60000, n - 60000);
+  magnitudes.merge(rest);
+  c10::phase_histogram<scalar_t> phases(bins);
+  phases.update(x.data(), n);
+  c10::set_num_threads(0);
+
+  ASSERT_EQ(magnitudes.discarded(), discarded_magnitude);
+  ASSERT_EQ(phases.discarded(), int64_t(1));
+  ASSERT_EQ(magnitudes.bin_edge(bins), max_magnitude);
+  ASSERT_LT(std::abs(phases.bin_edge(0) + scalar_t(PI)), scalar_t(1e-6));
+  // the approximations may only move elements that are within a few ulps of a bin edge
+  int64_t moved_magnitude = 0;
+  int64_t moved_phase = 0;
+  for (int64_t k = 0; k < bins; k++) {
+    moved_magnitude += std::abs(magnitudes.counts()[k] - expected_magnitude[k]);
+    moved_phase += std::abs(phases.counts()[k] - expected_phase[k]);
+  }
+  ASSERT_LT(moved_magnitude, int64_t(3));
+  ASSERT_LT(moved_phase, int64_t(3));
+  ASSERT_EQ(phases.counts()[0] > 0, true);
+}
+
+void test_stats() {
+  test_moments_<float>();
+  test_moments_<double>();
+  test_histogram_<float>();
+  test_histogram_<double>();
+}
+
+} // namespace stats
+
 void run_all_host_tests() {
   constructors::test_thrust_conversion();
   assignment::test_assign_thrust();
   io::test_io();
   test_std::test_values();
+  division::test_division();
+  scan::test_scan();
+  rng::test_random();
+  linalg::test_linalg();
+  fft::test_fft();
+  view::test_view();
+  fast_math::test_fast_math();
+  power::test_pow();
+  selection::test_select();
+  poly::test_poly();
+  rotation::test_rotation();
+  correlation::test_correlate();
+  stats::test_stats();
 }
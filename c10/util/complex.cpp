@@ -0,0 +1,51 @@
+// Explicit instantiations of the non-constexpr c10::complex functions and of the batched kernels,
+// for translation units built with C10_COMPLEX_EXTERN_TEMPLATES, see [Header layout] in
+// c10/util/complex_core.h. Everything else is constexpr or inline, and stays in the headers.
+
+#include <c10/util/complex.h>
+#include <c10/util/complex_correlate.h>
+#include <c10/util/complex_division.h>
+#include <c10/util/complex_fft.h>
+#include <c10/util/complex_linalg.h>
+#include <c10/util/complex_poly.h>
+#include <c10/util/complex_pow.h>
+#include <c10/util/complex_random.h>
+#include <c10/util/complex_rotation.h>
+#include <c10/util/complex_scan.h>
+#include <c10/util/complex_select.h>
+#include <c10/util/complex_stats.h>
+#include <c10/util/complex_stft.h>
+
+C10_COMPLEX_IO_INSTANTIATE(, c10::Half)
+C10_COMPLEX_IO_INSTANTIATE(, float)
+C10_COMPLEX_IO_INSTANTIATE(, double)
+
+namespace std {
+
+C10_COMPLEX_MATH_INSTANTIATE(, float)
+C10_COMPLEX_MATH_INSTANTIATE(, double)
+
+} // namespace std
+
+namespace c10 {
+
+#define C10_COMPLEX_INSTANTIATE_ALL(T) \
+  C10_COMPLEX_CORRELATE_INSTANTIATE(, T) \
+  C10_COMPLEX_DIVISION_INSTANTIATE(, T) \
+  C10_COMPLEX_FFT_INSTANTIATE(, T) \
+  C10_COMPLEX_LINALG_INSTANTIATE(, T) \
+  C10_COMPLEX_POLY_INSTANTIATE(, T) \
+  C10_COMPLEX_POW_INSTANTIATE(, T) \
+  C10_COMPLEX_RANDOM_INSTANTIATE(, T) \
+  C10_COMPLEX_ROTATION_INSTANTIATE(, T) \
+  C10_COMPLEX_SCAN_INSTANTIATE(, T) \
+  C10_COMPLEX_SELECT_INSTANTIATE(, T) \
+  C10_COMPLEX_STATS_INSTANTIATE(, T) \
+  C10_COMPLEX_STFT_INSTANTIATE(, T)
+
+C10_COMPLEX_INSTANTIATE_ALL(float)
+C10_COMPLEX_INSTANTIATE_ALL(double)
+
+#undef C10_COMPLEX_INSTANTIATE_ALL
+
+} // namespace c10
@@ -0,0 +1,559 @@
+#pragma once
+
+#include <cmath>
+#include <type_traits>
+#include <c10/util/complex_instrumentation.h>
+
+#if defined(__CUDACC__) || defined(__HIPCC__)
+#include <thrust/complex.h>
+#endif
+
+namespace c10 {
+
+using Half = short;  // Just for the convenience of prototyping
+#if defined(__CUDACC__) || defined(__HIPCC__)
+#define C10_HOST_DEVICE __host__ __device__ // Just for the convenience of prototyping
+#else
+#define C10_HOST_DEVICE
+#endif
+
+// see [Header layout]
+#if defined(C10_COMPLEX_EXTERN_TEMPLATES) && defined(C10_COMPLEX_INSTRUMENTATION)
+#error "C10_COMPLEX_EXTERN_TEMPLATES cannot be used with C10_COMPLEX_INSTRUMENTATION, the instantiations in c10/util/complex.cpp are not instrumented"
+#endif
+#if defined(C10_COMPLEX_EXTERN_TEMPLATES) && !defined(__CUDACC__) && !defined(__HIPCC__)
+#define C10_COMPLEX_EXTERN_TEMPLATES_ENABLED
+#endif
+
+// c10::complex is an implementation of complex numbers that aims
+// to work on all devices supported by PyTorch
+//
+// Most of the APIs duplicates std::complex
+// Reference: https://en.cppreference.com/w/cpp/numeric/complex
+//
+// [Note on Constructors]
+//
+// The APIs of constructors are mostly copied from C++ standard:
+//   https://en.cppreference.com/w/cpp/numeric/complex/complex
+//
+// Since C++14, all constructors are constexpr in std::complex
+//
+// There are three types of constructors:
+// - initializing from real and imag: 
+//     `constexpr complex( const T& re = T(), const T& im = T() );`
+// - implicitly-declared copy constructor
+// - converting constructors
+//
+// Converting constructors: 
+// - std::complex defines converting constructor between float/double/long double,
+//   while we define converting constructor between c10::Half/float/double.
+// - For these converting constructors, upcasting is implicit, downcasting is
+//   explicit.
+// - We also define explicit casting from std::complex/thrust::complex
+//   - Note that the conversion from thrust is not constexpr, because
+//     thrust does not define them as constexpr ????
+//
+//
+// [Operator =]
+//
+// The APIs of operator = are mostly copied from C++ standard:
+//   https://en.cppreference.com/w/cpp/numeric/complex/operator%3D
+//
+// Since C++20, all operator= are constexpr. Although we are not bulding with
+// C++20, we also obey this behavior.
+//
+// There are three types of assign operator:
+// - Assign a real value from the same scalar type
+//   - In std, this is templated as complex& operator=(const T& x)
+//     with specialization `complex& operator=(T x)` for float/double/long double
+//     Since we only support c10::Half, float and double, on will use `complex& operator=(T x)`
+// - Copy assignment operator and converting assignment operator
+//   - There is no specialization of converting assignemnt operators, which type is
+//     convertible is soly depend on whether the scalar type is convertable
+//
+// In addition to the standard assignment, we also provide assignment operators with std and thrust
+//
+//
+// [Casting operators]
+//
+// std::complex does not have casting operators. We define casting operators casting to std::complex and thrust::complex
+//
+//
+// [Operator ""]
+//
+// std::complex has custom literals `i`, `if` and `if` defined in namespace `std::literals::complex_literals`.
+// We define our own custom literals in the namespace `c10::complex_literals`. Our custom literals does not
+// follow the same behavior as in std::complex, instead, we define _ih, _if, _id to construct half/float/double
+// complex literals.
+//
+//
+// [real() and imag()]
+//
+// In C++20, there are two overload of these functions, one it to return the real/imag, another is to set real/imag,
+// they are both constexpr. We follow this design.
+//
+//
+// [Operator +=,-=,*=,/=]
+//
+// Since C++20, these operators become constexpr. In our implementation, they are also constexpr.
+//
+// There are two types of such operators: operating with a real number, or operating with another complex number.
+// For the operating with a real number, the generic template form has argument type `const T &`, while the overload
+// for float/double/long double has `T`. We will follow the same type as float/double/long double in std.
+//
+// Complex division does not use the textbook formula for floating point types, see [Complex division]
+// in c10/util/complex_division.h for the algorithm used and for the alternatives.
+//
+// [Unary operator +-]
+//
+// Since C++20, they are constexpr. We also make them expr
+//
+// [Binary operators +-*/]
+//
+// Each operator has three versions (taking + as example):
+// - complex + complex
+// - complex + real
+// - real + complex
+//
+// [Operator ==, !=]
+// 
+// Each operator has three versions (taking == as example):
+// - complex == complex
+// - complex == real
+// - real == complex
+// 
+// Some of them are removed on C++20, but we decide to keep them
+//
+// [Operator <<, >>]
+//
+// These are implemented by casting to std::complex, in c10/util/complex_io.h
+//
+// [Header layout]
+//
+// This header is the minimal core: the class, its operators and the std functions that only
+// need <cmath>. It does not include <complex> or any stream header, which dominate the cost of
+// parsing it. The conversions from and to std::complex are declared here, but they are only
+// enabled for std::complex<U> by c10/util/complex.h, which includes <complex>. So:
+// - c10/util/complex_core.h: arithmetic only
+// - c10/util/complex_io.h: operator << and >>
+// - c10/util/complex.h: everything, including std::complex interop and the math functions
+//
+// With C10_COMPLEX_EXTERN_TEMPLATES defined, the headers declare extern templates for the
+// non-constexpr functions and the batched kernels, and c10/util/complex.cpp instantiates them
+// for c10::Half, float and double, so they are compiled once instead of once per translation unit.
+// complex.cpp is built without instrumentation, so C10_COMPLEX_EXTERN_TEMPLATES is an error
+// together with C10_COMPLEX_INSTRUMENTATION: the instrumented translation unit would link
+// against the uninstrumented instantiations, see [Complex instrumentation].
+//
+// c10/benchmark/compile_time/run.sh measures what both save; CI runs it after the tests.
+
+template<typename T>
+struct complex;
+
+namespace detail {
+
+// true for std::complex<U>, see [Header layout]
+template<typename C>
+struct is_std_complex: std::false_type {};
+
+} // namespace detail
+
+template<typename T>
+struct alignas(sizeof(T) * 2) complex_common {
+  T storage[2];
+
+  constexpr complex_common(): storage{T(), T()} {}
+  constexpr complex_common(const T& re, const T& im = T()): storage{re, im} {}
+  template<typename C, typename std::enable_if<detail::is_std_complex<C>::value, int>::type = 0>
+  constexpr complex_common(const C &other): complex_common(other.real(), other.imag()) {}
+#if defined(__CUDACC__) || defined(__HIPCC__)
+  template<typename U>
+  C10_HOST_DEVICE complex_common(const thrust::complex<U> &other): complex_common(other.real(), other.imag()) {}
+#endif
+
+  constexpr complex<T> &operator =(T re) {
+    storage[0] = re;
+    return static_cast<complex<T> &>(*this);
+  }
+
+  constexpr complex<T> &operator +=(T re) {
+    T a = storage[0];
+    storage[0] = a + re;
+    C10_COMPLEX_RECORD_OP(add, 1, a, storage[1], re, T(), storage[0], storage[1]);
+    return static_cast<complex<T> &>(*this);
+  }
+
+  constexpr complex<T> &operator -=(T re) {
+    T a = storage[0];
+    storage[0] = a - re;
+    C10_COMPLEX_RECORD_OP(subtract, 1, a, storage[1], re, T(), storage[0], storage[1]);
+    return static_cast<complex<T> &>(*this);
+  }
+
+  constexpr complex<T> &operator *=(T re) {
+    T a = storage[0];
+    T b = storage[1];
+    storage[0] = a * re;
+    storage[1] = b * re;
+    C10_COMPLEX_RECORD_OP(multiply, 2, a, b, re, T(), storage[0], storage[1]);
+    return static_cast<complex<T> &>(*this);
+  }
+
+  constexpr complex<T> &operator /=(T re) {
+    T a = storage[0];
+    T b = storage[1];
+    storage[0] = a / re;
+    storage[1] = b / re;
+    C10_COMPLEX_RECORD_OP(divide, 2, a, b, re, T(), storage[0], storage[1]);
+    return static_cast<complex<T> &>(*this);
+  }
+
+  template<typename U>
+  constexpr complex<T> &operator =(const complex<U> &rhs) {
+    storage[0] = rhs.real();
+    storage[1] = rhs.imag();
+    return static_cast<complex<T> &>(*this);
+  }
+
+  template<typename U>
+  constexpr complex<T> &operator +=(const complex<U> &rhs) {
+    T a = storage[0];
+    T b = storage[1];
+    storage[0] = a + rhs.real();
+    storage[1] = b + rhs.imag();
+    C10_COMPLEX_RECORD_OP(add, 2, a, b, rhs.real(), rhs.imag(), storage[0], storage[1]);
+    return static_cast<complex<T> &>(*this);
+  }
+
+  template<typename U>
+  constexpr complex<T> &operator -=(const complex<U> &rhs) {
+    T a = storage[0];
+    T b = storage[1];
+    storage[0] = a - rhs.real();
+    storage[1] = b - rhs.imag();
+    C10_COMPLEX_RECORD_OP(subtract, 2, a, b, rhs.real(), rhs.imag(), storage[0], storage[1]);
+    return static_cast<complex<T> &>(*this);
+  }
+
+  template<typename U>
+  constexpr complex<T> &operator *=(const complex<U> &rhs) {
+    // (a + bi) * (c + di) = (a*c - b*d) + (a * d + b * c) i
+    T a = storage[0];
+    T b = storage[1];
+    U c = rhs.real();
+    U d = rhs.imag();
+    storage[0] = a * c - b * d;
+    storage[1] = a * d + b * c;
+    C10_COMPLEX_RECORD_OP(multiply, 6, a, b, c, d, storage[0], storage[1]);
+    return static_cast<complex<T> &>(*this);
+  }
+
+  template<typename U>
+  constexpr complex<T> &operator /=(const complex<U> &rhs) {
+    // (a + bi) / (c + di) = (ac + bd)/(c^2 + d^2) + (bc - ad)/(c^2 + d^2) i
+    //
+    // For floating point, c^2 + d^2 overflows/underflows long before the quotient does,
+    // so we use Smith's algorithm with the Baudin-Smith fix for r == 0 instead.
+    // See [Complex division] in c10/util/complex_division.h
+    using R = decltype(T() * U());
+    R a = storage[0];
+    R b = storage[1];
+    R c = rhs.real();
+    R d = rhs.imag();
+    if (!std::is_floating_point<R>::value) {
+      auto denominator = c * c + d * d;
+      storage[0] = (a * c + b * d) / denominator;
+      storage[1] = (b * c - a * d) / denominator;
+    } else if ((d < R(0) ? -d : d) <= (c < R(0) ? -c : c)) {
+      R r = d / c;
+      R denominator = c + d * r;
+      if (r != R(0)) {
+        storage[0] = (a + b * r) / denominator;
+        storage[1] = (b - a * r) / denominator;
+      } else {
+        storage[0] = (a + d * (b / c)) / denominator;
+        storage[1] = (b - d * (a / c)) / denominator;
+      }
+    } else {
+      R r = c / d;
+      R denominator = c * r + d;
+      if (r != R(0)) {
+        storage[0] = (a * r + b) / denominator;
+        storage[1] = (b * r - a) / denominator;
+      } else {
+        storage[0] = (c * (a / d) + b) / denominator;
+        storage[1] = (c * (b / d) - a) / denominator;
+      }
+    }
+    C10_COMPLEX_RECORD_OP(divide, 9, a, b, c, d, storage[0], storage[1]);
+    return static_cast<complex<T> &>(*this);
+  }
+
+  template<typename C, typename std::enable_if<detail::is_std_complex<C>::value, int>::type = 0>
+  constexpr complex<T> &operator =(const C &rhs) {
+    storage[0] = rhs.real();
+    storage[1] = rhs.imag();
+    return static_cast<complex<T> &>(*this);
+  }
+
+#if defined(__CUDACC__) || defined(__HIPCC__)
+  template<typename U>
+  C10_HOST_DEVICE complex<T> &operator =(const thrust::complex<U> &rhs) {
+    storage[0] = rhs.real();
+    storage[1] = rhs.imag();
+    return static_cast<complex<T> &>(*this);
+  }
+#endif
+
+  template<typename C, typename std::enable_if<detail::is_std_complex<C>::value, int>::type = 0>
+  explicit constexpr operator C() const {
+    return C(real(), imag());
+  }
+
+#if defined(__CUDACC__) || defined(__HIPCC__)
+  template<typename U>
+  explicit operator thrust::complex<U>() const {
+    return thrust::complex<U>(thrust::complex<T>(real(), imag()));
+  }
+#endif
+
+  constexpr T real() const {
+    return storage[0];
+  }
+  constexpr void real(T value) {
+    storage[0] = value;
+  }
+  constexpr T imag() const {
+    return storage[1];
+  }
+  constexpr void imag(T value) {
+    storage[1] = value;
+  }
+};
+
+template<>
+struct alignas(4) complex<c10::Half>: public complex_common<c10::Half> {
+  using complex_common<c10::Half>::complex_common;
+  constexpr complex(): complex_common() {}; // needed by CUDA 9.x
+  explicit constexpr complex(const complex<float> &other);
+  explicit constexpr complex(const complex<double> &other);
+};
+
+template<>
+struct alignas(8) complex<float>: public complex_common<float> {
+  using complex_common<float>::complex_common;
+  constexpr complex(): complex_common() {}; // needed by CUDA 9.x
+  constexpr complex(const complex<c10::Half> &other);
+  explicit constexpr complex(const complex<double> &other);
+};
+
+template<>
+struct alignas(16) complex<double>: public complex_common<double> {
+  using complex_common<double>::complex_common;
+  constexpr complex(): complex_common() {}; // needed by CUDA 9.x
+  constexpr complex(const complex<c10::Half> &other);
+  constexpr complex(const complex<float> &other);
+};
+
+constexpr complex<c10::Half>::complex(const complex<float> &other): complex_common(other.real(), other.imag()) {}
+constexpr complex<c10::Half>::complex(const complex<double> &other): complex_common(other.real(), other.imag()) {}
+constexpr complex<float>::complex(const complex<c10::Half> &other): complex_common(other.real(), other.imag()) {}
+constexpr complex<float>::complex(const complex<double> &other): complex_common(other.real(), other.imag()) {}
+constexpr complex<double>::complex(const complex<c10::Half> &other): complex_common(other.real(), other.imag()) {}
+constexpr complex<double>::complex(const complex<float> &other): complex_common(other.real(), other.imag()) {}
+
+namespace complex_literals {
+
+constexpr complex<c10::Half> operator"" _ih(long double imag) {
+  return complex<c10::Half>(c10::Half(), static_cast<c10::Half>(imag));
+}
+
+constexpr complex<float> operator"" _if(long double imag) {
+  return complex<float>(float(), static_cast<float>(imag));
+}
+
+constexpr complex<double> operator"" _id(long double imag) {
+  return complex<double>(double(), static_cast<double>(imag));
+}
+
+} // namespace complex_literals
+
+} // namespace c10
+
+template<typename T>
+constexpr c10::complex<T> operator+(const c10::complex<T>& val) {
+  return val;
+}
+
+template<typename T>
+constexpr c10::complex<T> operator-(const c10::complex<T>& val) {
+  return c10::complex<T>(-val.real(), -val.imag());
+}
+
+template<typename T>
+constexpr c10::complex<T> operator+(const c10::complex<T>& lhs, const c10::complex<T>& rhs) {
+  c10::complex<T> result = lhs;
+  return result += rhs;
+}
+
+template<typename T>
+constexpr c10::complex<T> operator+(const c10::complex<T>& lhs, const T& rhs) {
+  c10::complex<T> result = lhs;
+  return result += rhs;
+}
+
+template<typename T>
+constexpr c10::complex<T> operator+(const T& lhs, const c10::complex<T>& rhs) {
+  c10::complex<T> result = rhs;
+  return result += lhs;
+}
+
+template<typename T>
+constexpr c10::complex<T> operator-(const c10::complex<T>& lhs, const c10::complex<T>& rhs) {
+  c10::complex<T> result = lhs;
+  return result -= rhs;
+}
+
+template<typename T>
+constexpr c10::complex<T> operator-(const c10::complex<T>& lhs, const T& rhs) {
+  c10::complex<T> result = lhs;
+  return result -= rhs;
+}
+
+template<typename T>
+constexpr c10::complex<T> operator-(const T& lhs, const c10::complex<T>& rhs) {
+  c10::complex<T> result = -rhs;
+  return result += lhs;
+}
+
+template<typename T>
+constexpr c10::complex<T> operator*(const c10::complex<T>& lhs, const c10::complex<T>& rhs) {
+  c10::complex<T> result = lhs;
+  return result *= rhs;
+}
+
+template<typename T>
+constexpr c10::complex<T> operator*(const c10::complex<T>& lhs, const T& rhs) {
+  c10::complex<T> result = lhs;
+  return result *= rhs;
+}
+
+template<typename T>
+constexpr c10::complex<T> operator*(const T& lhs, const c10::complex<T>& rhs) {
+  c10::complex<T> result = rhs;
+  return result *= lhs;
+}
+
+template<typename T>
+constexpr c10::complex<T> operator/(const c10::complex<T>& lhs, const c10::complex<T>& rhs) {
+  c10::complex<T> result = lhs;
+  return result /= rhs;
+}
+
+template<typename T>
+constexpr c10::complex<T> operator/(const c10::complex<T>& lhs, const T& rhs) {
+  c10::complex<T> result = lhs;
+  return result /= rhs;
+}
+
+template<typename T>
+constexpr c10::complex<T> operator/(const T& lhs, const c10::complex<T>& rhs) {
+  c10::complex<T> result(lhs, T());
+  return result /= rhs;
+}
+
+template<typename T>
+constexpr bool operator==(const c10::complex<T>& lhs, const c10::complex<T>& rhs) {
+  return (lhs.real() == rhs.real()) && (lhs.imag() == rhs.imag());
+}
+
+template<typename T>
+constexpr bool operator==(const c10::complex<T>& lhs, const T& rhs) {
+  return (lhs.real() == rhs) && (lhs.imag() == T());
+}
+
+template<typename T>
+constexpr bool operator==(const T& lhs, const c10::complex<T>& rhs) {
+  return (lhs == rhs.real()) && (T() == rhs.imag());
+}
+
+template<typename T>
+constexpr bool operator!=(const c10::complex<T>& lhs, const c10::complex<T>& rhs) {
+  return !(lhs == rhs);
+}
+
+template<typename T>
+constexpr bool operator!=(const c10::complex<T>& lhs, const T& rhs) {
+  return !(lhs == rhs);
+}
+
+template<typename T>
+constexpr bool operator!=(const T& lhs, const c10::complex<T>& rhs) {
+  return !(lhs == rhs);
+}
+
+// std functions
+//
+// The implementation of these functions also follow the design of C++20
+
+namespace std {
+
+template<typename T>
+constexpr T real(const c10::complex<T>& z) {
+  return z.real();
+}
+
+template<typename T>
+constexpr T imag(const c10::complex<T>& z) {
+  return z.imag();
+}
+
+template<typename T>
+C10_HOST_DEVICE T abs(const c10::complex<T>& z) {
+  return std::hypot(std::real(z), std::imag(z));
+}
+
+template<typename T>
+C10_HOST_DEVICE T arg(const c10::complex<T>& z) {
+  return std::atan2(std::imag(z), std::real(z));
+}
+
+template<typename T>
+constexpr T norm(const c10::complex<T>& z) {
+  return z.real() * z.real() + z.imag() * z.imag();
+}
+
+// For std::conj, there are other versions of it:
+//   constexpr std::complex<float> conj( float z );
+//   template< class DoubleOrInteger >
+//   constexpr std::complex<double> conj( DoubleOrInteger z );
+//   constexpr std::complex<long double> conj( long double z );
+// These are not implemented
+// TODO(@zasdfgbnm): implement them as c10::conj
+template<typename T>
+constexpr c10::complex<T> conj(const c10::complex<T>& z) {
+  return c10::complex<T>(z.real(), -z.imag());
+}
+
+// Thrust does not have complex --> complex version of thrust::proj,
+// so this function is not implemented at c10 right now.
+// TODO(@zasdfgbnm): implement it by ourselves
+
+// There is no c10 version of std::polar, because std::polar always
+// returns std::complex. Use c10::polar instead;
+
+} // namespace std
+
+namespace c10 {
+
+template<typename T>
+C10_HOST_DEVICE c10::complex<T> polar(const T& r, const T& theta = T()) {
+#if defined(__CUDACC__) || defined(__HIPCC__)
+  // TODO(@zasdfgbnm): thrust::complex only support float and double, how do we handle c10::Half?
+  return static_cast<c10::complex<T>>(thrust::polar(r, theta));
+#else
+  return c10::complex<T>(r * std::cos(theta), r * std::sin(theta));
+#endif
+}
+
+} // namespace c10
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <c10/util/complex.h>
+#include <c10/util/complex_fft.h>
+#include <c10/util/complex_view.h>
+#include <c10/util/parallel.h>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+// [Matched filter bank]
+//
+// correlator<T> cross-correlates signals against a bank of templates of the same length m:
+//   out_t[i] = sum_j conj(h_t[j]) x[i + j],   i = 0, ..., length - m
+// which is numpy.correlate(x, h_t, 'valid'), the output of the matched filter for h_t. Only the
+// positions where the template fits entirely inside the signal are computed; to process a stream
+// block by block, prepend the last m - 1 samples of the previous block to each block.
+//
+// There are two ways to compute it, picked once at construction by the template length:
+// - direct: m complex multiply-adds per output. The signal is deinterleaved into real and
+//   imaginary parts a block at a time, and each template tap is applied to the whole block with
+//   a loop that the compiler can vectorize. Best for short templates.
+// - fft: overlap-save with FFTs of size fft_size() >= 4 m. The spectra of the templates are
+//   computed once at construction, and the spectrum of each segment of the signal is computed
+//   once per call and shared by all templates, so each template only costs a pointwise product
+//   and an inverse FFT per segment.
+//
+// The work is split across threads by (template, block of output) pairs, so both a large bank
+// and a single long template use all cores. A correlator is immutable after construction and
+// can be shared between threads.
+
+namespace c10 {
+
+enum class correlation_method {
+  automatic,
+  direct,
+  fft
+};
+
+namespace detail {
+
+// Templates up to this length are correlated directly. The measured crossover is around 64 taps
+// when the direct loop is vectorized with AVX, and around 8 taps without vectorization.
+constexpr int64_t correlate_direct_max_length = 16;
+constexpr int64_t correlate_min_fft_size = 256;
+constexpr int64_t correlate_block_size = 1024;
+
+inline int64_t next_power_of_two(int64_t n) {
+  int64_t p = 1;
+  while (p < n) {
+    p *= 2;
+  }
+  return p;
+}
+
+} // namespace detail
+
+template<typename T>
+class correlator {
+ public:
+  // templates: num_templates x template_length, row-major
+  correlator(const complex<T>* templates, int64_t num_templates, int64_t template_length,
+             correlation_method method = correlation_method::automatic)
+    : num_templates_(num_templates), m_(template_length),
+      method_(resolve(method, template_length)),
+      n_fft_(method_ == correlation_method::fft ? fft_size_for(template_length) : 1),
+      forward_(n_fft_), inverse_(n_fft_, true) {
+    if (num_templates <= 0 || template_length <= 0) {
+      throw std::invalid_argument("correlator: the number and length of templates must be positive");
+    }
+    if (method_ == correlation_method::direct) {
+      taps_.resize(num_templates * m_);
+      for (int64_t k = 0; k < num_templates * m_; k++) {
+        taps_[k] = std::conj(templates[k]);
+      }
+      return;
+    }
+    // conj(FFT(h)) / n, so that the inverse FFT of X * spectrum is the correlation
+    spectra_.resize(num_templates * n_fft_);
+    const T scale = T(1) / static_cast<T>(n_fft_);
+    parallel_for(0, num_templates, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t t = begin; t < end; t++) {
+        const complex<T>* h = templates + t * m_;
+        const int64_t m = m_;
+        complex<T>* spectrum = spectra_.data() + t * n_fft_;
+        forward_.execute_from([h, m](int64_t j) { return j < m ? h[j] : complex<T>(); }, spectrum);
+        for (int64_t k = 0; k < n_fft_; k++) {
+          spectrum[k] = std::conj(spectrum[k]) * scale;
+        }
+      }
+    });
+  }
+
+  int64_t num_templates() const {
+    return num_templates_;
+  }
+
+  int64_t template_length() const {
+    return m_;
+  }
+
+  // direct or fft, never automatic
+  correlation_method method() const {
+    return method_;
+  }
+
+  // 1 for the direct method
+  int64_t fft_size() const {
+    return n_fft_;
+  }
+
+  int64_t output_length(int64_t length) const {
+    return std::max<int64_t>(0, length - m_ + 1);
+  }
+
+  // out: num_templates() x output_length(length), row-major
+  void correlate(const complex<T>* x, int64_t length, complex<T>* out) const {
+    C10_COMPLEX_KERNEL("c10::correlator::correlate");
+    if (output_length(length) == 0) {
+      return;
+    }
+    if (method_ == correlation_method::direct) {
+      correlate_direct(x, length, out);
+    } else {
+      correlate_fft(x, length, out);
+    }
+  }
+
+ private:
+  static correlation_method resolve(correlation_method method, int64_t m) {
+    if (method != correlation_method::automatic) {
+      return method;
+    }
+    return m <= detail::correlate_direct_max_length ? correlation_method::direct : correlation_method::fft;
+  }
+
+  static int64_t fft_size_for(int64_t m) {
+    return std::max(detail::correlate_min_fft_size, detail::next_power_of_two(4 * m));
+  }
+
+  void correlate_direct(const complex<T>* x, int64_t length, complex<T>* out) const {
+    const int64_t outputs = output_length(length);
+    const int64_t blocks = divup(outputs, detail::correlate_block_size);
+    const T* xv = view_as_real(x);
+    parallel_for(0, num_templates_ * blocks, 1, [&](int64_t begin, int64_t end) {
+      std::vector<T> x_re(detail::correlate_block_size + m_ - 1);
+      std::vector<T> x_im(detail::correlate_block_size + m_ - 1);
+      T acc_re[detail::correlate_block_size];
+      T acc_im[detail::correlate_block_size];
+      for (int64_t item = begin; item < end; item++) {
+        const int64_t t = item / blocks;
+        const int64_t offset = (item % blocks) * detail::correlate_block_size;
+        const int64_t size = std::min(detail::correlate_block_size, outputs - offset);
+        for (int64_t i = 0; i < size + m_ - 1; i++) {
+          x_re[i] = xv[2 * (offset + i)];
+          x_im[i] = xv[2 * (offset + i) + 1];
+        }
+        std::fill(acc_re, acc_re + size, T(0));
+        std::fill(acc_im, acc_im + size, T(0));
+        const complex<T>* taps = taps_.data() + t * m_;
+        for (int64_t j = 0; j < m_; j++) {
+          const T hr = taps[j].real();
+          const T hi = taps[j].imag();
+          const T* xr = x_re.data() + j;
+          const T* xi = x_im.data() + j;
+          for (int64_t i = 0; i < size; i++) {
+            acc_re[i] += hr * xr[i] - hi * xi[i];
+            acc_im[i] += hr * xi[i] + hi * xr[i];
+          }
+        }
+        complex<T>* y = out + t * outputs + offset;
+        for (int64_t i = 0; i < size; i++) {
+          y[i] = complex<T>(acc_re[i], acc_im[i]);
+        }
+      }
+    });
+  }
+
+  void correlate_fft(const complex<T>* x, int64_t length, complex<T>* out) const {
+    const int64_t outputs = output_length(length);
+    const int64_t step = n_fft_ - m_ + 1;
+    const int64_t segments = divup(outputs, step);
+    const int64_t n = n_fft_;
+    // spectra of the zero padded segments x[s * step, s * step + n)
+    std::vector<complex<T>> segment_spectra(segments * n);
+    parallel_for(0, segments, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t s = begin; s < end; s++) {
+        const complex<T>* segment = x + s * step;
+        const int64_t available = std::min(n, length - s * step);
+        forward_.execute_from([segment, available](int64_t j) {
+          return j < available ? segment[j] : complex<T>();
+        }, segment_spectra.data() + s * n);
+      }
+    });
+    parallel_for(0, num_templates_ * segments, 1, [&](int64_t begin, int64_t end) {
+      std::vector<complex<T>> scratch(n);
+      for (int64_t item = begin; item < end; item++) {
+        const int64_t t = item / segments;
+        const int64_t s = item % segments;
+        const complex<T>* spectrum = spectra_.data() + t * n;
+        const complex<T>* segment = segment_spectra.data() + s * n;
+        for (int64_t k = 0; k < n; k++) {
+          scratch[k] = segment[k] * spectrum[k];
+        }
+        inverse_.execute(scratch.data(), scratch.data());
+        const int64_t size = std::min(step, outputs - s * step);
+        std::copy(scratch.data(), scratch.data() + size, out + t * outputs + s * step);
+      }
+    });
+  }
+
+  int64_t num_templates_;
+  int64_t m_;
+  correlation_method method_;
+  int64_t n_fft_;
+  fft_plan<T> forward_;
+  fft_plan<T> inverse_;
+  std::vector<complex<T>> taps_;
+  std::vector<complex<T>> spectra_;
+};
+
+// explicit instantiations, see [Header layout] in c10/util/complex_core.h
+#define C10_COMPLEX_CORRELATE_INSTANTIATE(prefix, T) \
+  prefix template class correlator<T>;
+
+#ifdef C10_COMPLEX_EXTERN_TEMPLATES_ENABLED
+C10_COMPLEX_CORRELATE_INSTANTIATE(extern, float)
+C10_COMPLEX_CORRELATE_INSTANTIATE(extern, double)
+#endif
+
+} // namespace c10
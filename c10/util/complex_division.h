@@ -0,0 +1,106 @@
+#pragma once
+
+#include <c10/util/complex.h>
+#include <cmath>
+#include <cstdint>
+
+// [Complex division]
+//
+// The textbook formula
+//   (a + bi) / (c + di) = (ac + bd)/(c^2 + d^2) + (bc - ad)/(c^2 + d^2) i
+// computes c^2 + d^2, which overflows when |c| or |d| is above sqrt(max) and underflows
+// when both are below sqrt(min), even if the quotient itself is perfectly representable.
+//
+// operator/ and operator/= use Smith's algorithm: divide by the larger of |c| and |d| first,
+// so that the intermediate ratio r = d/c (or c/d) is in [-1, 1]. When r underflows to zero,
+// the Baudin-Smith variant reorders the products so that no precision is lost.
+// Reference: M. Baudin, R. L. Smith, "A Robust Complex Division in Scilab", 2012
+//
+// The following alternatives are provided when a different trade-off is wanted:
+// - div_naive: the textbook formula, kept for comparison.
+// - div_scaled: scales the divisor by a power of two before applying the textbook formula,
+//   as in C99 Annex G. As robust as Smith's algorithm, but without the branch on |c| vs |d|.
+// - div_fast: computes 1/(c^2 + d^2) once and multiplies. Cheapest per element, but has the
+//   same range limitations as div_naive.
+//
+// For dividing many numerators by the same divisor, the batched version of div computes the
+// reciprocal of the divisor once with Smith's algorithm and multiplies every numerator by it.
+// This costs one extra rounding compared to dividing each element.
+
+namespace c10 {
+
+template<typename T>
+constexpr complex<T> div_naive(const complex<T>& lhs, const complex<T>& rhs) {
+  T a = lhs.real();
+  T b = lhs.imag();
+  T c = rhs.real();
+  T d = rhs.imag();
+  T denominator = c * c + d * d;
+  return complex<T>((a * c + b * d) / denominator, (b * c - a * d) / denominator);
+}
+
+template<typename T>
+constexpr complex<T> div_smith(const complex<T>& lhs, const complex<T>& rhs) {
+  return lhs / rhs;
+}
+
+template<typename T>
+C10_HOST_DEVICE complex<T> div_scaled(const complex<T>& lhs, const complex<T>& rhs) {
+  T c = rhs.real();
+  T d = rhs.imag();
+  T m = std::fmax(std::fabs(c), std::fabs(d));
+  if (m == T(0) || !std::isfinite(m)) {
+    return div_naive(lhs, rhs);
+  }
+  int e = std::ilogb(m);
+  c = std::scalbn(c, -e);
+  d = std::scalbn(d, -e);
+  T a = lhs.real();
+  T b = lhs.imag();
+  T denominator = c * c + d * d;
+  return complex<T>(
+    std::scalbn((a * c + b * d) / denominator, -e),
+    std::scalbn((b * c - a * d) / denominator, -e));
+}
+
+template<typename T>
+constexpr complex<T> div_fast(const complex<T>& lhs, const complex<T>& rhs) {
+  T a = lhs.real();
+  T b = lhs.imag();
+  T c = rhs.real();
+  T d = rhs.imag();
+  T scale = T(1) / (c * c + d * d);
+  return complex<T>((a * c + b * d) * scale, (b * c - a * d) * scale);
+}
+
+// out[i] = num[i] / den[i], using div_fast
+template<typename T>
+C10_HOST_DEVICE void div_fast(const complex<T>* num, const complex<T>* den, complex<T>* out, int64_t n) {
+  C10_COMPLEX_KERNEL("c10::div_fast");
+  for (int64_t i = 0; i < n; i++) {
+    out[i] = div_fast(num[i], den[i]);
+  }
+}
+
+// out[i] = num[i] / den, computing the reciprocal of den only once
+template<typename T>
+C10_HOST_DEVICE void div(const complex<T>* num, const complex<T>& den, complex<T>* out, int64_t n) {
+  C10_COMPLEX_KERNEL("c10::div");
+  const complex<T> inv = T(1) / den;
+  for (int64_t i = 0; i < n; i++) {
+    out[i] = num[i] * inv;
+  }
+}
+
+// explicit instantiations, see [Header layout] in c10/util/complex_core.h
+#define C10_COMPLEX_DIVISION_INSTANTIATE(prefix, T) \
+  prefix template complex<T> div_scaled<T>(const complex<T>&, const complex<T>&); \
+  prefix template void div_fast<T>(const complex<T>*, const complex<T>*, complex<T>*, int64_t); \
+  prefix template void div<T>(const complex<T>*, const complex<T>&, complex<T>*, int64_t);
+
+#ifdef C10_COMPLEX_EXTERN_TEMPLATES_ENABLED
+C10_COMPLEX_DIVISION_INSTANTIATE(extern, float)
+C10_COMPLEX_DIVISION_INSTANTIATE(extern, double)
+#endif
+
+} // namespace c10
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <c10/util/complex.h>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// [Fast complex math]
+//
+// c10::fast contains approximations of the complex transcendental functions for complex<float>,
+// for code that needs throughput rather than correctly rounded results, like complex activation
+// functions. Unlike the functions in complex_math.h, these do not call libm. They are built from
+// the Cephes single precision minimax polynomials with branch free range reduction: every
+// data dependent choice is written as a select, so that a loop over these functions can be
+// vectorized by the compiler.
+//
+// Accuracy is given as the normwise relative error |f(z) - exact| / |exact|, in units of
+// FLT_EPSILON = 2^-23, measured against double precision std::complex on the domain below:
+//
+//   function        domain                                          max error
+//   exp(z)          |Re z| <= 87, |Im z| <= 8192                    2
+//   log(z)          1e-18 <= |z| <= 1e18                            3
+//   sqrt(z)         1e-18 <= |z| <= 1e18                            2
+//   tanh(z)         |Im z| <= 8192, |cosh z| >= 0.1                 4
+//   sigmoid(z)      |Im z| <= 8192, |1 + exp(-z)| >= 0.1 max(1, |exp(-z)|)   8
+//   pow(z, w)       as log(z) and exp(w log z)                      3 max(1, |w log z|)
+//
+// Outside of these domains, the results lose accuracy gracefully (e.g. sin and cos of a large
+// imaginary part), but infinities and NaNs are not handled like std::complex does.
+//
+// sqrt uses std::sqrt for the real square roots, which only vectorizes with -fno-math-errno.
+
+namespace c10 {
+namespace fast {
+
+namespace detail {
+
+C10_HOST_DEVICE inline int32_t float_as_int(float x) {
+  int32_t i;
+  std::memcpy(&i, &x, sizeof(i));
+  return i;
+}
+
+C10_HOST_DEVICE inline float int_as_float(int32_t i) {
+  float x;
+  std::memcpy(&x, &i, sizeof(x));
+  return x;
+}
+
+// condition ? a : b, as a bitwise blend, so that compilers do not turn it back into a branch
+// (with the default -ftrapping-math, they cannot speculate a floating point operation out of one)
+C10_HOST_DEVICE inline float select(bool condition, float a, float b) {
+  const int32_t mask = -static_cast<int32_t>(condition);
+  return int_as_float((float_as_int(a) & mask) | (float_as_int(b) & ~mask));
+}
+
+// unlike std::fmin/std::fmax, these do not special case NaN
+C10_HOST_DEVICE inline float min(float a, float b) {
+  return select(a < b, a, b);
+}
+
+C10_HOST_DEVICE inline float max(float a, float b) {
+  return select(a > b, a, b);
+}
+
+// rounds to the nearest integer for |x| < 2^22 by adding and subtracting 1.5 * 2^23
+C10_HOST_DEVICE inline float round_to_int(float x) {
+  const float magic = 12582912.0f;
+  return (x + magic) - magic;
+}
+
+// exp(x), relative error <= 1 ulp for |x| <= 87
+C10_HOST_DEVICE inline float exp(float x) {
+  const float clamped = min(max(x, -87.3f), 88.7f);
+  const float n = round_to_int(clamped * 1.44269504088896341f);
+  // Cody-Waite reduction with ln(2) = 0.693359375 - 2.12194440e-4
+  float r = clamped - n * 0.693359375f;
+  r = r + n * 2.12194440e-4f;
+  float p = 1.9875691500e-4f;
+  p = p * r + 1.3981999507e-3f;
+  p = p * r + 8.3334519073e-3f;
+  p = p * r + 4.1665795894e-2f;
+  p = p * r + 1.6666665459e-1f;
+  p = p * r + 5.0000001201e-1f;
+  p = p * r * r + r + 1.0f;
+  // n is in [-126, 128], so 2^n is applied in two halves to stay in the normal range
+  const int32_t k = static_cast<int32_t>(n);
+  const float result = p * int_as_float(((k >> 1) + 127) << 23) * int_as_float(((k - (k >> 1)) + 127) << 23);
+  return select(x < -87.3f, 0.0f, select(x > 88.7f, INFINITY, result));
+}
+
+// log(x) for normal positive x, relative error <= 1 ulp
+C10_HOST_DEVICE inline float log(float x) {
+  const int32_t bits = float_as_int(x);
+  // x = m * 2^e with m in [sqrt(1/2), sqrt(2))
+  const int32_t shifted = bits - 0x3f3504f3;
+  const float e = static_cast<float>(shifted >> 23);
+  const float m = int_as_float((shifted & 0x007fffff) + 0x3f3504f3);
+  const float t = m - 1.0f;
+  const float z = t * t;
+  float p = 7.0376836292e-2f;
+  p = p * t - 1.1514610310e-1f;
+  p = p * t + 1.1676998740e-1f;
+  p = p * t - 1.2420140846e-1f;
+  p = p * t + 1.4249322787e-1f;
+  p = p * t - 1.6668057665e-1f;
+  p = p * t + 2.0000714765e-1f;
+  p = p * t - 2.4999993993e-1f;
+  p = p * t + 3.3333331174e-1f;
+  float y = t * z * p;
+  y = y - e * 2.12194440e-4f;
+  y = y - 0.5f * z;
+  return (t + y) + e * 0.693359375f;
+}
+
+// log(1 + t) for t > -1, without losing the low bits of t
+C10_HOST_DEVICE inline float log1p(float t) {
+  const float u = 1.0f + t;
+  const float d = u - 1.0f;
+  return select(d == 0.0f, t, log(u) * (t / d));
+}
+
+// sin(x) and cos(x), absolute error <= 1 ulp of 1 for |x| <= 8192
+C10_HOST_DEVICE inline void sincos(float x, float& s, float& c) {
+  const float ax = std::fabs(x);
+  // j is the even multiple of pi/4 nearest to |x|, so that r is in [-pi/4, pi/4]
+  const int32_t j = (static_cast<int32_t>(min(ax * 1.27323954473516f, 16777216.0f)) + 1) & ~1;
+  const float y = static_cast<float>(j);
+  float r = ax - y * 0.78515625f;
+  r = r - y * 2.4187564849853515625e-4f;
+  r = r - y * 3.77489497744594108e-8f;
+  const float z = r * r;
+  const float sin_r = ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f) * z * r + r;
+  const float cos_r = ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f) * z * z
+                      - 0.5f * z + 1.0f;
+  const bool swap = (j & 2) != 0;
+  const float sin_abs = select(swap, cos_r, sin_r);
+  const float cos_abs = select(swap, sin_r, cos_r);
+  s = select(((j & 4) != 0) != (x < 0.0f), -sin_abs, sin_abs);
+  c = select(((j + 2) & 4) != 0, -cos_abs, cos_abs);
+}
+
+// atan2(y, x), absolute error <= 2 ulp of pi
+C10_HOST_DEVICE inline float atan2(float y, float x) {
+  const float ax = std::fabs(x);
+  const float ay = std::fabs(y);
+  const float hi = max(ax, ay);
+  const float lo = min(ax, ay);
+  const float t = select(hi == 0.0f, 0.0f, lo / hi);
+  // reduce t in [0, 1] to [-tan(pi/8), tan(pi/8)] with atan(t) = pi/4 + atan((t - 1) / (t + 1))
+  const bool reduce = t > 0.4142135623730950f;
+  const float u = select(reduce, (t - 1.0f) / (t + 1.0f), t);
+  const float z = u * u;
+  float a = (((8.05374449538e-2f * z - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z - 3.33329491539e-1f) * z * u + u;
+  a = select(reduce, a + 0.785398163397448f, a);
+  a = select(ay > ax, 1.570796326794897f - a, a);
+  a = select(x < 0.0f, 3.141592653589793f - a, a);
+  return std::copysign(a, y);
+}
+
+// sinh(x) and cosh(x), from one exp(|x|), with a polynomial for sinh near 0 to avoid cancellation
+C10_HOST_DEVICE inline void sinhcosh(float x, float& sh, float& ch) {
+  const float ax = std::fabs(x);
+  const float e = exp(ax);
+  const float inv = 1.0f / e;
+  const float z = x * x;
+  const float small = ((((2.7557319e-6f * z + 1.9841270e-4f) * z + 8.3333333e-3f) * z + 1.6666667e-1f) * z) * x + x;
+  sh = select(ax < 0.5f, small, std::copysign(0.5f * (e - inv), x));
+  ch = 0.5f * (e + inv);
+}
+
+} // namespace detail
+
+C10_HOST_DEVICE inline complex<float> exp(const complex<float>& z) {
+  float s, c;
+  detail::sincos(z.imag(), s, c);
+  const float m = detail::exp(z.real());
+  return complex<float>(m * c, m * s);
+}
+
+C10_HOST_DEVICE inline complex<float> log(const complex<float>& z) {
+  const float x = z.real();
+  const float y = z.imag();
+  const float norm = x * x + y * y;
+  // near |z| = 1, log|z| = log1p((big - 1)(big + 1) + small^2) / 2 avoids cancelling the low bits of |z|^2
+  const float big = detail::max(std::fabs(x), std::fabs(y));
+  const float small = detail::min(std::fabs(x), std::fabs(y));
+  const bool near_one = (norm > 0.5f) & (norm < 2.0f);
+  const float log_abs = 0.5f * detail::select(
+    near_one, detail::log1p((big - 1.0f) * (big + 1.0f) + small * small), detail::log(norm));
+  return complex<float>(log_abs, detail::atan2(y, x));
+}
+
+C10_HOST_DEVICE inline complex<float> sqrt(const complex<float>& z) {
+  const float x = z.real();
+  const float y = z.imag();
+  const float t = std::sqrt(0.5f * (std::sqrt(x * x + y * y) + std::fabs(x)));
+  const float other = detail::select(t == 0.0f, 0.0f, 0.5f * y / t);
+  // for x < 0 the large component goes to the imaginary part, with the sign of y
+  return complex<float>(
+    detail::select(x >= 0.0f, t, std::fabs(other)),
+    detail::select(x >= 0.0f, other, std::copysign(t, y)));
+}
+
+C10_HOST_DEVICE inline complex<float> tanh(const complex<float>& z) {
+  // tanh(x + iy) = (sinh(x) cosh(x) + i sin(y) cos(y)) / (sinh(x)^2 + cos(y)^2)
+  // tanh saturates to +-1 in float for |x| > 9, so x is clamped to avoid overflow
+  const float x = detail::min(detail::max(z.real(), -9.0f), 9.0f);
+  float sh, ch, s, c;
+  detail::sinhcosh(x, sh, ch);
+  detail::sincos(z.imag(), s, c);
+  const float inv = 1.0f / (sh * sh + c * c);
+  return complex<float>(sh * ch * inv, s * c * inv);
+}
+
+C10_HOST_DEVICE inline complex<float> sigmoid(const complex<float>& z) {
+  // 1 / (1 + exp(-z)) for Re z >= 0, and exp(z) / (1 + exp(z)) otherwise, so that |exp(-+z)| <= 1
+  const bool positive = z.real() >= 0.0f;
+  const float m = detail::exp(-std::fabs(z.real()));
+  float s, c;
+  detail::sincos(z.imag(), s, c);
+  const float wr = m * c;
+  const float wi = detail::select(positive, -m * s, m * s);
+  const float dr = 1.0f + wr;
+  const float inv = 1.0f / (dr * dr + wi * wi);
+  const float rr = dr * inv;
+  const float ri = -wi * inv;
+  return complex<float>(
+    detail::select(positive, rr, wr * rr - wi * ri),
+    detail::select(positive, ri, wr * ri + wi * rr));
+}
+
+C10_HOST_DEVICE inline complex<float> pow(const complex<float>& z, const complex<float>& w) {
+  const complex<float> result = exp(w * log(z));
+  const bool zero = (z.real() == 0.0f) & (z.imag() == 0.0f);
+  return complex<float>(detail::select(zero, 0.0f, result.real()), detail::select(zero, 0.0f, result.imag()));
+}
+
+C10_HOST_DEVICE inline complex<float> pow(const complex<float>& z, float w) {
+  return pow(z, complex<float>(w));
+}
+
+// Batched versions, out may be the same as in. pow takes one exponent shared by all elements,
+// like c10::pow in c10/util/complex_pow.h
+
+C10_HOST_DEVICE inline void exp(const complex<float>* in, complex<float>* out, int64_t n) {
+  C10_COMPLEX_KERNEL("c10::fast::exp");
+  for (int64_t i = 0; i < n; i++) {
+    out[i] = exp(in[i]);
+  }
+}
+
+C10_HOST_DEVICE inline void log(const complex<float>* in, complex<float>* out, int64_t n) {
+  C10_COMPLEX_KERNEL("c10::fast::log");
+  for (int64_t i = 0; i < n; i++) {
+    out[i] = log(in[i]);
+  }
+}
+
+C10_HOST_DEVICE inline void sqrt(const complex<float>* in, complex<float>* out, int64_t n) {
+  C10_COMPLEX_KERNEL("c10::fast::sqrt");
+  for (int64_t i = 0; i < n; i++) {
+    out[i] = sqrt(in[i]);
+  }
+}
+
+C10_HOST_DEVICE inline void tanh(const complex<float>* in, complex<float>* out, int64_t n) {
+  C10_COMPLEX_KERNEL("c10::fast::tanh");
+  for (int64_t i = 0; i < n; i++) {
+    out[i] = tanh(in[i]);
+  }
+}
+
+C10_HOST_DEVICE inline void sigmoid(const complex<float>* in, complex<float>* out, int64_t n) {
+  C10_COMPLEX_KERNEL("c10::fast::sigmoid");
+  for (int64_t i = 0; i < n; i++) {
+    out[i] = sigmoid(in[i]);
+  }
+}
+
+C10_HOST_DEVICE inline void pow(const complex<float>* in, const complex<float>& w, complex<float>* out, int64_t n) {
+  C10_COMPLEX_KERNEL("c10::fast::pow");
+  for (int64_t i = 0; i < n; i++) {
+    out[i] = pow(in[i], w);
+  }
+}
+
+C10_HOST_DEVICE inline void pow(const complex<float>* in, float w, complex<float>* out, int64_t n) {
+  pow(in, complex<float>(w), out, n);
+}
+
+} // namespace fast
+} // namespace c10
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <c10/util/complex.h>
+#include <c10/util/parallel.h>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// [Complex FFT]
+//
+// fft_plan<T> precomputes the twiddle factors and the bit reversal permutation of a power of
+// two length n, and then computes
+//   forward: out[k] = sum_j in[j] exp(-2 pi i j k / n)
+//   inverse: out[k] = sum_j in[j] exp(+2 pi i j k / n)
+// with the iterative radix-2 algorithm. Like FFTW, neither direction is normalized, so
+// inverse(forward(x)) = n x.
+//
+// execute_from(load, out) reads input element j as load(j) during the bit reversal pass, so
+// that callers can fuse windowing, zero padding or type conversion into the transform instead
+// of making another pass over memory.
+//
+// A plan is immutable after construction and can be shared between threads.
+
+namespace c10 {
+
+template<typename T>
+class fft_plan {
+ public:
+  explicit fft_plan(int64_t n, bool inverse = false) : n_(n), inverse_(inverse) {
+    if (n <= 0 || (n & (n - 1)) != 0) {
+      throw std::invalid_argument("fft_plan: length must be a power of two");
+    }
+    int64_t log2n = 0;
+    while ((int64_t(1) << log2n) < n) {
+      log2n++;
+    }
+    bitrev_.resize(n);
+    for (int64_t i = 0; i < n; i++) {
+      int64_t r = 0;
+      for (int64_t b = 0; b < log2n; b++) {
+        r |= ((i >> b) & 1) << (log2n - 1 - b);
+      }
+      bitrev_[i] = r;
+    }
+    // twiddles_[k] = exp(-+2 pi i k / n) for k < n / 2, computed in double
+    const double sign = inverse ? 1.0 : -1.0;
+    twiddles_.resize(n / 2);
+    for (int64_t k = 0; k < n / 2; k++) {
+      const double theta = sign * 6.283185307179586476925 * static_cast<double>(k) / static_cast<double>(n);
+      twiddles_[k] = complex<T>(static_cast<T>(std::cos(theta)), static_cast<T>(std::sin(theta)));
+    }
+  }
+
+  int64_t size() const {
+    return n_;
+  }
+
+  bool inverse() const {
+    return inverse_;
+  }
+
+  // in and out may be the same pointer
+  void execute(const complex<T>* in, complex<T>* out) const {
+    if (in == out) {
+      C10_COMPLEX_KERNEL("c10::fft_plan::execute");
+      for (int64_t i = 0; i < n_; i++) {
+        if (i < bitrev_[i]) {
+          std::swap(out[i], out[bitrev_[i]]);
+        }
+      }
+      butterflies(out);
+    } else {
+      execute_from([in](int64_t j) { return in[j]; }, out);
+    }
+  }
+
+  // out must not alias the memory read by load
+  template<typename F>
+  void execute_from(const F& load, complex<T>* out) const {
+    C10_COMPLEX_KERNEL("c10::fft_plan::execute");
+    for (int64_t i = 0; i < n_; i++) {
+      out[i] = load(bitrev_[i]);
+    }
+    butterflies(out);
+  }
+
+  // transforms batch contiguous signals of length n, in parallel
+  void execute_batch(const complex<T>* in, complex<T>* out, int64_t batch) const {
+    C10_COMPLEX_KERNEL("c10::fft_plan::execute_batch");
+    parallel_for(0, batch, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t b = begin; b < end; b++) {
+        execute(in + b * n_, out + b * n_);
+      }
+    });
+  }
+
+ private:
+  void butterflies(complex<T>* data) const {
+    for (int64_t half = 1, stride = n_ / 2; half < n_; half *= 2, stride /= 2) {
+      for (int64_t start = 0; start < n_; start += 2 * half) {
+        complex<T>* lo = data + start;
+        complex<T>* hi = data + start + half;
+        for (int64_t j = 0; j < half; j++) {
+          const complex<T> t = hi[j] * twiddles_[j * stride];
+          hi[j] = lo[j] - t;
+          lo[j] += t;
+        }
+      }
+    }
+  }
+
+  int64_t n_;
+  bool inverse_;
+  std::vector<int64_t> bitrev_;
+  std::vector<complex<T>> twiddles_;
+};
+
+// explicit instantiations, see [Header layout] in c10/util/complex_core.h
+#define C10_COMPLEX_FFT_INSTANTIATE(prefix, T) \
+  prefix template class fft_plan<T>;
+
+#ifdef C10_COMPLEX_EXTERN_TEMPLATES_ENABLED
+C10_COMPLEX_FFT_INSTANTIATE(extern, float)
+C10_COMPLEX_FFT_INSTANTIATE(extern, double)
+#endif
+
+} // namespace c10
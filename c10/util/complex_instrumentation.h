@@ -0,0 +1,402 @@
+#pragma once
+
+// [Complex instrumentation]
+//
+// Compiling with -DC10_COMPLEX_INSTRUMENTATION turns on:
+//
+// - Op counters: every arithmetic compound assignment of c10::complex (and so every binary
+//   operator, which is implemented with them) counts one op of its kind and the number of real
+//   floating point operations it does: 1 for scalar +/-, 2 for complex +/- and scalar * and /,
+//   6 for complex * and 9 for complex / (Smith's algorithm). Counters are per thread, so counting
+//   is a plain load and store of a thread_local; get_counters() sums over all threads, including
+//   the ones that already exited, like the workers of c10::parallel_for.
+// - Kernel timers: every batched kernel records its number of calls, its wall time and the flops
+//   counted while it ran, see get_kernel_stats(). The time and flops of a kernel include the
+//   kernels it calls. Its flops are the ones done on its thread while it ran, plus the ones of
+//   the c10::parallel_for workers it started, which report them to it when they finish. Kernels
+//   running concurrently on unrelated threads are not counted.
+// - NaN/Inf origin tracer: the first operation that produces a non-finite result from finite
+//   operands is recorded, with its operands and the innermost kernel running on the calling
+//   thread (workers of c10::parallel_for inherit it), see get_first_nonfinite(). An optional
+//   handler is called when it happens, e.g. to abort or to break in a debugger.
+//
+// Kernels that compute on the real and imaginary parts directly (e.g. c10::fast) do not go
+// through the operators, so they show up in the kernel timers but not in the op counters or
+// in the tracer.
+//
+// Without C10_COMPLEX_INSTRUMENTATION, this header only defines the hooks as empty macros, and
+// nothing is compiled in. With it, the operators stay constant expressions: the op hook is
+// skipped during constant evaluation with __builtin_is_constant_evaluated(), so only the
+// operations done at run time are counted. Compilers without that builtin do not count ops nor
+// trace non-finite values, and only the kernel timers work. The hooks are also empty in device
+// code, where thread_local and the standard library are not available. It cannot be combined
+// with C10_COMPLEX_EXTERN_TEMPLATES, see [Header layout] in c10/util/complex_core.h.
+
+#if defined(C10_COMPLEX_INSTRUMENTATION) && !defined(__CUDA_ARCH__) && !defined(__HIP_DEVICE_COMPILE__)
+#define C10_COMPLEX_INSTRUMENTATION_ENABLED
+#endif
+
+// The op hook is called from the constexpr operators, so it needs to know whether it runs at
+// compile time
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define C10_COMPLEX_HAS_IS_CONSTANT_EVALUATED
+#endif
+#endif
+#if !defined(C10_COMPLEX_HAS_IS_CONSTANT_EVALUATED) && \
+    ((defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925))
+#define C10_COMPLEX_HAS_IS_CONSTANT_EVALUATED
+#endif
+
+#ifdef C10_COMPLEX_INSTRUMENTATION
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace c10 {
+namespace instrumentation {
+
+enum class op : int {
+  add = 0,
+  subtract,
+  multiply,
+  divide,
+  num_ops
+};
+
+constexpr int num_ops = static_cast<int>(op::num_ops);
+
+inline const char* op_name(op kind) {
+  switch (kind) {
+    case op::add: return "add";
+    case op::subtract: return "subtract";
+    case op::multiply: return "multiply";
+    case op::divide: return "divide";
+    default: return "unknown";
+  }
+}
+
+struct counters {
+  uint64_t ops[num_ops] = {};
+  uint64_t flops = 0;
+};
+
+struct kernel_stats {
+  std::string name;
+  uint64_t calls = 0;
+  uint64_t nanoseconds = 0;
+  uint64_t flops = 0;
+};
+
+struct nonfinite_origin {
+  op kind;
+  const char* kernel; // nullptr if the operation did not run inside a kernel
+  std::thread::id thread;
+  double lhs_real, lhs_imag;
+  double rhs_real, rhs_imag;
+  double result_real, result_imag;
+};
+
+using nonfinite_handler = void (*)(const nonfinite_origin&);
+
+class scoped_kernel;
+
+namespace detail {
+
+struct thread_state;
+class inherit_kernel;
+
+struct registry {
+  std::mutex mutex;
+  std::vector<thread_state*> live;
+  counters retired;
+  std::map<std::string, kernel_stats> kernels;
+  bool has_nonfinite = false;
+  nonfinite_origin first_nonfinite;
+  std::atomic<nonfinite_handler> handler{nullptr};
+};
+
+inline registry& get_registry() {
+  static registry r;
+  return r;
+}
+
+// Only the owning thread writes to the counters, other threads only read them
+struct thread_state {
+  std::atomic<uint64_t> ops[num_ops];
+  std::atomic<uint64_t> flops;
+  // innermost kernel running on this thread, or the one inherited from the caller of parallel_for
+  scoped_kernel* kernel = nullptr;
+  // flops of the parallel_for workers of the kernels of this thread, only used by this thread
+  uint64_t worker_flops = 0;
+
+  thread_state() {
+    for (auto& count : ops) {
+      count.store(0, std::memory_order_relaxed);
+    }
+    flops.store(0, std::memory_order_relaxed);
+    registry& r = get_registry();
+    std::lock_guard<std::mutex> guard(r.mutex);
+    r.live.push_back(this);
+  }
+
+  ~thread_state() {
+    registry& r = get_registry();
+    std::lock_guard<std::mutex> guard(r.mutex);
+    add_to(r.retired);
+    r.live.erase(std::find(r.live.begin(), r.live.end(), this));
+  }
+
+  void add_to(counters& total) const {
+    for (int i = 0; i < num_ops; i++) {
+      total.ops[i] += ops[i].load(std::memory_order_relaxed);
+    }
+    total.flops += flops.load(std::memory_order_relaxed);
+  }
+
+  void reset() {
+    for (auto& count : ops) {
+      count.store(0, std::memory_order_relaxed);
+    }
+    flops.store(0, std::memory_order_relaxed);
+  }
+};
+
+inline thread_state& local() {
+  static thread_local thread_state state;
+  return state;
+}
+
+inline void increment(std::atomic<uint64_t>& count, uint64_t value) {
+  count.store(count.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+// flops done by the calling thread, and by the finished workers of its kernels
+inline uint64_t attributable_flops() {
+  const thread_state& state = local();
+  return state.flops.load(std::memory_order_relaxed) + state.worker_flops;
+}
+
+template<typename T>
+bool is_finite(T x) {
+  return !std::is_floating_point<T>::value || std::isfinite(static_cast<double>(x));
+}
+
+inline void record_nonfinite(const nonfinite_origin& origin) {
+  registry& r = get_registry();
+  {
+    std::lock_guard<std::mutex> guard(r.mutex);
+    if (r.has_nonfinite) {
+      return;
+    }
+    r.has_nonfinite = true;
+    r.first_nonfinite = origin;
+  }
+  nonfinite_handler handler = r.handler.load();
+  if (handler != nullptr) {
+    handler(origin);
+  }
+}
+
+} // namespace detail
+
+class scoped_kernel {
+ public:
+  explicit scoped_kernel(const char* name)
+      : name_(name), previous_(detail::local().kernel),
+        flops_(detail::attributable_flops()), start_(std::chrono::steady_clock::now()) {
+    detail::local().kernel = this;
+  }
+
+  ~scoped_kernel() {
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start_).count();
+    detail::thread_state& state = detail::local();
+    // the enclosing kernels of this thread include the flops of the workers of this one
+    state.worker_flops += worker_flops_.load(std::memory_order_relaxed);
+    const uint64_t flops = detail::attributable_flops() - flops_;
+    state.kernel = previous_;
+    detail::registry& r = detail::get_registry();
+    std::lock_guard<std::mutex> guard(r.mutex);
+    kernel_stats& stats = r.kernels[name_];
+    stats.name = name_;
+    stats.calls++;
+    stats.nanoseconds += static_cast<uint64_t>(elapsed);
+    stats.flops += flops;
+  }
+
+  scoped_kernel(const scoped_kernel&) = delete;
+  scoped_kernel& operator=(const scoped_kernel&) = delete;
+
+  const char* name() const {
+    return name_;
+  }
+
+ private:
+  friend class detail::inherit_kernel;
+
+  const char* name_;
+  scoped_kernel* previous_;
+  uint64_t flops_;
+  std::chrono::steady_clock::time_point start_;
+  std::atomic<uint64_t> worker_flops_{0};
+};
+
+namespace detail {
+
+// lhs = (a, b), rhs = (c, d), result = (re, im)
+template<typename A, typename C, typename R>
+void record_op(op kind, uint64_t flops, A a, A b, C c, C d, R re, R im) {
+  thread_state& state = local();
+  increment(state.ops[static_cast<int>(kind)], 1);
+  increment(state.flops, flops);
+  if (!(is_finite(re) && is_finite(im)) && is_finite(a) && is_finite(b) && is_finite(c) && is_finite(d)) {
+    record_nonfinite(nonfinite_origin{kind, state.kernel != nullptr ? state.kernel->name() : nullptr,
+                                      std::this_thread::get_id(),
+                                      static_cast<double>(a), static_cast<double>(b),
+                                      static_cast<double>(c), static_cast<double>(d),
+                                      static_cast<double>(re), static_cast<double>(im)});
+  }
+}
+
+inline scoped_kernel* current_scope() {
+  return local().kernel;
+}
+
+// Makes the kernel of the thread that calls parallel_for the current kernel of a worker, and
+// reports the flops of the worker to it when the worker finishes
+class inherit_kernel {
+ public:
+  explicit inherit_kernel(scoped_kernel* kernel)
+      : kernel_(kernel), previous_(local().kernel), flops_(attributable_flops()) {
+    local().kernel = kernel;
+  }
+  ~inherit_kernel() {
+    if (kernel_ != nullptr) {
+      kernel_->worker_flops_.fetch_add(attributable_flops() - flops_, std::memory_order_relaxed);
+    }
+    local().kernel = previous_;
+  }
+  inherit_kernel(const inherit_kernel&) = delete;
+  inherit_kernel& operator=(const inherit_kernel&) = delete;
+
+ private:
+  scoped_kernel* kernel_;
+  scoped_kernel* previous_;
+  uint64_t flops_;
+};
+
+} // namespace detail
+
+// name of the innermost kernel running on the calling thread, or nullptr
+inline const char* current_kernel() {
+  const scoped_kernel* kernel = detail::local().kernel;
+  return kernel != nullptr ? kernel->name() : nullptr;
+}
+
+// counters of the calling thread
+inline counters get_thread_counters() {
+  counters total;
+  detail::local().add_to(total);
+  return total;
+}
+
+// counters summed over all threads
+inline counters get_counters() {
+  detail::registry& r = detail::get_registry();
+  std::lock_guard<std::mutex> guard(r.mutex);
+  counters total = r.retired;
+  for (const detail::thread_state* state : r.live) {
+    state->add_to(total);
+  }
+  return total;
+}
+
+// Should not be called while other threads are counting, their counts could be lost or kept
+inline void reset_counters() {
+  detail::registry& r = detail::get_registry();
+  std::lock_guard<std::mutex> guard(r.mutex);
+  r.retired = counters();
+  for (detail::thread_state* state : r.live) {
+    state->reset();
+  }
+}
+
+// sorted by decreasing time
+inline std::vector<kernel_stats> get_kernel_stats() {
+  detail::registry& r = detail::get_registry();
+  std::vector<kernel_stats> result;
+  {
+    std::lock_guard<std::mutex> guard(r.mutex);
+    for (const auto& entry : r.kernels) {
+      result.push_back(entry.second);
+    }
+  }
+  std::stable_sort(result.begin(), result.end(), [](const kernel_stats& a, const kernel_stats& b) {
+    return a.nanoseconds > b.nanoseconds;
+  });
+  return result;
+}
+
+inline void reset_kernel_stats() {
+  detail::registry& r = detail::get_registry();
+  std::lock_guard<std::mutex> guard(r.mutex);
+  r.kernels.clear();
+}
+
+// returns false if no non-finite value was produced since the last reset
+inline bool get_first_nonfinite(nonfinite_origin& origin) {
+  detail::registry& r = detail::get_registry();
+  std::lock_guard<std::mutex> guard(r.mutex);
+  if (r.has_nonfinite) {
+    origin = r.first_nonfinite;
+  }
+  return r.has_nonfinite;
+}
+
+inline void reset_nonfinite() {
+  detail::registry& r = detail::get_registry();
+  std::lock_guard<std::mutex> guard(r.mutex);
+  r.has_nonfinite = false;
+}
+
+// nullptr removes the handler
+inline void set_nonfinite_handler(nonfinite_handler handler) {
+  detail::get_registry().handler.store(handler);
+}
+
+} // namespace instrumentation
+} // namespace c10
+
+#endif // C10_COMPLEX_INSTRUMENTATION
+
+#ifdef C10_COMPLEX_INSTRUMENTATION_ENABLED
+#define C10_COMPLEX_CONCAT_IMPL(a, b) a##b
+#define C10_COMPLEX_CONCAT(a, b) C10_COMPLEX_CONCAT_IMPL(a, b)
+#ifdef C10_COMPLEX_HAS_IS_CONSTANT_EVALUATED
+#define C10_COMPLEX_RECORD_OP(kind, flops, a, b, c, d, re, im) \
+  (__builtin_is_constant_evaluated() ? (void)0 : \
+   ::c10::instrumentation::detail::record_op(::c10::instrumentation::op::kind, flops, a, b, c, d, re, im))
+#else
+#define C10_COMPLEX_RECORD_OP(kind, flops, a, b, c, d, re, im) ((void)0)
+#endif
+#define C10_COMPLEX_KERNEL(name) \
+  ::c10::instrumentation::scoped_kernel C10_COMPLEX_CONCAT(c10_complex_kernel_, __LINE__)(name)
+#define C10_COMPLEX_CURRENT_KERNEL() ::c10::instrumentation::detail::current_scope()
+#define C10_COMPLEX_INHERIT_KERNEL(kernel) \
+  ::c10::instrumentation::detail::inherit_kernel C10_COMPLEX_CONCAT(c10_complex_inherit_, __LINE__)(kernel)
+#else
+#define C10_COMPLEX_RECORD_OP(kind, flops, a, b, c, d, re, im) ((void)0)
+#define C10_COMPLEX_KERNEL(name) ((void)0)
+#define C10_COMPLEX_CURRENT_KERNEL() nullptr
+#define C10_COMPLEX_INHERIT_KERNEL(kernel) ((void)(kernel))
+#endif
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <c10/util/complex_core.h>
+#include <complex>
+#include <istream>
+#include <ostream>
+
+// [Operator <<, >>]
+//
+// Stream I/O of c10::complex, in the same format as std::complex: "(re,im)". Kept out of
+// c10/util/complex_core.h so that translation units that do not print complex numbers do not
+// have to parse the stream headers.
+
+template <typename T, typename CharT, typename Traits>
+std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const c10::complex<T>& x) {
+  return (os << std::complex<T>(x.real(), x.imag()));
+}
+
+template <typename T, typename CharT, typename Traits>
+std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, c10::complex<T>& x) {
+  std::complex<T> tmp;
+  is >> tmp;
+  x = c10::complex<T>(tmp.real(), tmp.imag());
+  return is;
+}
+
+// explicit instantiations, see [Header layout] in c10/util/complex_core.h
+#define C10_COMPLEX_IO_INSTANTIATE(prefix, T) \
+  prefix template std::ostream& operator<< <T, char, std::char_traits<char>>(std::ostream&, const c10::complex<T>&); \
+  prefix template std::istream& operator>> <T, char, std::char_traits<char>>(std::istream&, c10::complex<T>&);
+
+#ifdef C10_COMPLEX_EXTERN_TEMPLATES_ENABLED
+C10_COMPLEX_IO_INSTANTIATE(extern, c10::Half)
+C10_COMPLEX_IO_INSTANTIATE(extern, float)
+C10_COMPLEX_IO_INSTANTIATE(extern, double)
+#endif
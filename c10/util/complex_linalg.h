@@ -0,0 +1,257 @@
+#pragma once
+
+#include <c10/util/complex.h>
+#include <c10/util/complex_rotation.h>
+#include <c10/util/parallel.h>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// [Batched small matrix solvers]
+//
+// These solve many independent small systems A X = B in one call, e.g. one system per
+// subcarrier. Each A is a row-major matrix and each B a row-major rows x nrhs matrix, stored
+// back to back: matrix i starts at a + i * rows * cols and b + i * rows * nrhs.
+//
+// Like LAPACK, the solvers work in place: A is overwritten by its factorization and B by the
+// solution X. If info is not null, info[i] is set to 0 on success, or to k > 0 if system i
+// could not be solved because of the k-th column (zero pivot, zero diagonal of R, or leading
+// minor that is not positive definite). In that case the contents of A and B for system i are
+// unspecified.
+//
+// - lu_solve: LU with partial pivoting, for general square A. Pivots are chosen by |re| + |im|,
+//   as in LAPACK, to avoid a sqrt per candidate.
+// - qr_solve: Householder QR, for rows >= cols, and rows < cols throws std::invalid_argument.
+//   When rows > cols this is the least squares solution, which is stored in the first cols rows
+//   of B. The reflectors are generated by
+//   c10::householder, see c10/util/complex_rotation.h.
+// - cholesky_solve: A = L L^H for Hermitian positive definite A. Only the lower triangle of A
+//   is read.
+//
+// Systems are split across threads. Within one system the loops are plain row operations over
+// contiguous memory, which the compiler can vectorize.
+
+namespace c10 {
+
+namespace detail {
+
+template<typename T>
+T abs1(const complex<T>& z) {
+  return std::fabs(z.real()) + std::fabs(z.imag());
+}
+
+template<typename F>
+void for_each_system(int64_t batch, int32_t* info, const F& solve) {
+  parallel_for(0, batch, 16, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      int32_t status = solve(i);
+      if (info != nullptr) {
+        info[i] = status;
+      }
+    }
+  });
+}
+
+// solves R x = b for upper triangular R (n x n, leading dimension lda) and every column of b
+template<typename T>
+void back_substitute(const complex<T>* r, int64_t lda, complex<T>* b, int64_t n, int64_t nrhs) {
+  for (int64_t k = n - 1; k >= 0; k--) {
+    complex<T>* bk = b + k * nrhs;
+    for (int64_t j = k + 1; j < n; j++) {
+      const complex<T> rkj = r[k * lda + j];
+      const complex<T>* bj = b + j * nrhs;
+      for (int64_t c = 0; c < nrhs; c++) {
+        bk[c] -= rkj * bj[c];
+      }
+    }
+    const complex<T> inv = T(1) / r[k * lda + k];
+    for (int64_t c = 0; c < nrhs; c++) {
+      bk[c] *= inv;
+    }
+  }
+}
+
+template<typename T>
+int32_t lu_solve_one(complex<T>* a, complex<T>* b, int64_t n, int64_t nrhs) {
+  for (int64_t k = 0; k < n; k++) {
+    int64_t pivot = k;
+    T best = abs1(a[k * n + k]);
+    for (int64_t i = k + 1; i < n; i++) {
+      T candidate = abs1(a[i * n + k]);
+      if (candidate > best) {
+        best = candidate;
+        pivot = i;
+      }
+    }
+    if (best == T(0)) {
+      return static_cast<int32_t>(k + 1);
+    }
+    if (pivot != k) {
+      for (int64_t j = 0; j < n; j++) {
+        std::swap(a[k * n + j], a[pivot * n + j]);
+      }
+      for (int64_t c = 0; c < nrhs; c++) {
+        std::swap(b[k * nrhs + c], b[pivot * nrhs + c]);
+      }
+    }
+    const complex<T> inv = T(1) / a[k * n + k];
+    for (int64_t i = k + 1; i < n; i++) {
+      const complex<T> factor = a[i * n + k] * inv;
+      a[i * n + k] = factor;
+      for (int64_t j = k + 1; j < n; j++) {
+        a[i * n + j] -= factor * a[k * n + j];
+      }
+      for (int64_t c = 0; c < nrhs; c++) {
+        b[i * nrhs + c] -= factor * b[k * nrhs + c];
+      }
+    }
+  }
+  back_substitute(a, n, b, n, nrhs);
+  return 0;
+}
+
+template<typename T>
+int32_t qr_solve_one(complex<T>* a, complex<T>* b, int64_t rows, int64_t cols, int64_t nrhs, complex<T>* v) {
+  for (int64_t k = 0; k < cols; k++) {
+    // Householder reflector H = I - tau v v^H with H^H x = beta e_1, where x = A[k:, k]
+    for (int64_t i = k; i < rows; i++) {
+      v[i] = a[i * cols + k];
+    }
+    complex<T> tau;
+    householder(v[k], v + k + 1, rows - k, tau);
+    const complex<T> beta = v[k];
+    if (beta == complex<T>()) {
+      return static_cast<int32_t>(k + 1);
+    }
+    v[k] = complex<T>(T(1));
+    const complex<T> tau_h = std::conj(tau);
+
+    a[k * cols + k] = beta;
+    for (int64_t i = k + 1; i < rows; i++) {
+      a[i * cols + k] = complex<T>();
+    }
+    for (int64_t j = k + 1; j < cols; j++) {
+      complex<T> dot;
+      for (int64_t i = k; i < rows; i++) {
+        dot += std::conj(v[i]) * a[i * cols + j];
+      }
+      dot *= tau_h;
+      for (int64_t i = k; i < rows; i++) {
+        a[i * cols + j] -= v[i] * dot;
+      }
+    }
+    for (int64_t c = 0; c < nrhs; c++) {
+      complex<T> dot;
+      for (int64_t i = k; i < rows; i++) {
+        dot += std::conj(v[i]) * b[i * nrhs + c];
+      }
+      dot *= tau_h;
+      for (int64_t i = k; i < rows; i++) {
+        b[i * nrhs + c] -= v[i] * dot;
+      }
+    }
+  }
+  back_substitute(a, cols, b, cols, nrhs);
+  return 0;
+}
+
+template<typename T>
+int32_t cholesky_solve_one(complex<T>* a, complex<T>* b, int64_t n, int64_t nrhs) {
+  // A = L L^H, L is stored in the lower triangle of a
+  for (int64_t j = 0; j < n; j++) {
+    T diagonal = a[j * n + j].real();
+    for (int64_t k = 0; k < j; k++) {
+      diagonal -= std::norm(a[j * n + k]);
+    }
+    if (!(diagonal > T(0))) {
+      return static_cast<int32_t>(j + 1);
+    }
+    diagonal = std::sqrt(diagonal);
+    a[j * n + j] = complex<T>(diagonal);
+    const T inv = T(1) / diagonal;
+    for (int64_t i = j + 1; i < n; i++) {
+      complex<T> sum = a[i * n + j];
+      for (int64_t k = 0; k < j; k++) {
+        sum -= a[i * n + k] * std::conj(a[j * n + k]);
+      }
+      a[i * n + j] = sum * inv;
+    }
+  }
+  // L y = b
+  for (int64_t i = 0; i < n; i++) {
+    complex<T>* bi = b + i * nrhs;
+    for (int64_t k = 0; k < i; k++) {
+      const complex<T> lik = a[i * n + k];
+      const complex<T>* bk = b + k * nrhs;
+      for (int64_t c = 0; c < nrhs; c++) {
+        bi[c] -= lik * bk[c];
+      }
+    }
+    const T inv = T(1) / a[i * n + i].real();
+    for (int64_t c = 0; c < nrhs; c++) {
+      bi[c] *= inv;
+    }
+  }
+  // L^H x = y
+  for (int64_t i = n - 1; i >= 0; i--) {
+    complex<T>* bi = b + i * nrhs;
+    for (int64_t k = i + 1; k < n; k++) {
+      const complex<T> lki = std::conj(a[k * n + i]);
+      const complex<T>* bk = b + k * nrhs;
+      for (int64_t c = 0; c < nrhs; c++) {
+        bi[c] -= lki * bk[c];
+      }
+    }
+    const T inv = T(1) / a[i * n + i].real();
+    for (int64_t c = 0; c < nrhs; c++) {
+      bi[c] *= inv;
+    }
+  }
+  return 0;
+}
+
+} // namespace detail
+
+template<typename T>
+void lu_solve(complex<T>* a, complex<T>* b, int64_t n, int64_t nrhs, int64_t batch, int32_t* info = nullptr) {
+  C10_COMPLEX_KERNEL("c10::lu_solve");
+  detail::for_each_system(batch, info, [&](int64_t i) {
+    return detail::lu_solve_one(a + i * n * n, b + i * n * nrhs, n, nrhs);
+  });
+}
+
+template<typename T>
+void qr_solve(complex<T>* a, complex<T>* b, int64_t rows, int64_t cols, int64_t nrhs, int64_t batch, int32_t* info = nullptr) {
+  C10_COMPLEX_KERNEL("c10::qr_solve");
+  if (rows < cols) {
+    throw std::invalid_argument("qr_solve: rows must be at least cols");
+  }
+  detail::for_each_system(batch, info, [&](int64_t i) {
+    thread_local std::vector<complex<T>> v;
+    v.resize(rows);
+    return detail::qr_solve_one(a + i * rows * cols, b + i * rows * nrhs, rows, cols, nrhs, v.data());
+  });
+}
+
+template<typename T>
+void cholesky_solve(complex<T>* a, complex<T>* b, int64_t n, int64_t nrhs, int64_t batch, int32_t* info = nullptr) {
+  C10_COMPLEX_KERNEL("c10::cholesky_solve");
+  detail::for_each_system(batch, info, [&](int64_t i) {
+    return detail::cholesky_solve_one(a + i * n * n, b + i * n * nrhs, n, nrhs);
+  });
+}
+
+// explicit instantiations, see [Header layout] in c10/util/complex_core.h
+#define C10_COMPLEX_LINALG_INSTANTIATE(prefix, T) \
+  prefix template void lu_solve<T>(complex<T>*, complex<T>*, int64_t, int64_t, int64_t, int32_t*); \
+  prefix template void qr_solve<T>(complex<T>*, complex<T>*, int64_t, int64_t, int64_t, int64_t, int32_t*); \
+  prefix template void cholesky_solve<T>(complex<T>*, complex<T>*, int64_t, int64_t, int64_t, int32_t*);
+
+#ifdef C10_COMPLEX_EXTERN_TEMPLATES_ENABLED
+C10_COMPLEX_LINALG_INSTANTIATE(extern, float)
+C10_COMPLEX_LINALG_INSTANTIATE(extern, double)
+#endif
+
+} // namespace c10
@@ -0,0 +1,129 @@
+#if !defined(C10_INTERNAL_INCLUDE_COMPLEX_REMAINING_H)
+#error "c10/util/complex_math.h is not meant to be individually included. Include c10/util/complex.h instead."
+#endif
+
+namespace std {
+
+template<typename T>
+C10_HOST_DEVICE c10::complex<T> exp(const c10::complex<T>& x) {
+#if defined(__CUDACC__) || defined(__HIPCC__)
+  return static_cast<c10::complex<T>>(thrust::exp(static_cast<thrust::complex<T>>(x)));
+#else
+  return static_cast<c10::complex<T>>(std::exp(static_cast<std::complex<T>>(x)));
+#endif
+}
+
+template<typename T>
+C10_HOST_DEVICE c10::complex<T> log(const c10::complex<T>& x) {
+#if defined(__CUDACC__) || defined(__HIPCC__)
+  return static_cast<c10::complex<T>>(thrust::log(static_cast<thrust::complex<T>>(x)));
+#else
+  return static_cast<c10::complex<T>>(std::log(static_cast<std::complex<T>>(x)));
+#endif
+}
+
+// [pow]
+//
+// std::pow(std::complex, int) is not in the standard any more, and implementations compute it
+// as exp(y * log(x)), which costs a log and an exp. Here, integer powers use exponentiation by
+// squaring instead, which takes O(log |y|) multiplications and is constexpr. Negative powers are
+// computed as 1 / x^|y|.
+//
+// Operators on c10::complex are declared in the global namespace and are hidden by the ones
+// in namespace std, so the functions below use the compound assignment members instead.
+//
+// The integer overload only takes integral exponents, so that a real exponent of another
+// precision is not converted to an integer. Like std::pow on std::complex, mixed precision
+// arguments are promoted instead: pow(complex<float>, double) is a complex<double>.
+//
+// The other overloads follow libstdc++: pow(0, y) is 0, and a real exponent of a positive real
+// base is computed with the real pow.
+
+template<typename T, typename I,
+         typename std::enable_if<std::is_integral<I>::value && !std::is_same<I, bool>::value, int>::type = 0>
+constexpr c10::complex<T> pow(const c10::complex<T>& x, I y) {
+  using U = typename std::make_unsigned<I>::type;
+  c10::complex<T> result(T(1));
+  c10::complex<T> base = x;
+  // y < 0, written so that it does not warn for unsigned I
+  const bool negative = y < I(1) && y != I(0);
+  U n = negative ? static_cast<U>(U(0) - static_cast<U>(y)) : static_cast<U>(y);
+  while (n != 0) {
+    if (n & 1u) {
+      result *= base;
+    }
+    n >>= 1;
+    if (n != 0) {
+      base *= base;
+    }
+  }
+  if (negative) {
+    c10::complex<T> one(T(1));
+    return one /= result;
+  }
+  return result;
+}
+
+template<typename T>
+C10_HOST_DEVICE c10::complex<T> pow(const c10::complex<T>& x, const c10::complex<T>& y) {
+  if (x.real() == T() && x.imag() == T()) {
+    return c10::complex<T>();
+  }
+  c10::complex<T> t = std::log(x);
+  return std::exp(t *= y);
+}
+
+template<typename T>
+C10_HOST_DEVICE c10::complex<T> pow(const c10::complex<T>& x, const T& y) {
+  if (x.imag() == T() && x.real() > T()) {
+    return c10::complex<T>(std::pow(x.real(), y));
+  }
+  if (x.real() == T() && x.imag() == T()) {
+    return c10::complex<T>();
+  }
+  c10::complex<T> t = std::log(x);
+  return c10::polar(std::exp(y * t.real()), y * t.imag());
+}
+
+template<typename T>
+C10_HOST_DEVICE c10::complex<T> pow(const T& x, const c10::complex<T>& y) {
+  if (x > T()) {
+    return c10::polar(std::pow(x, y.real()), y.imag() * std::log(x));
+  }
+  return std::pow(c10::complex<T>(x), y);
+}
+
+template<typename T, typename U,
+         typename std::enable_if<std::is_floating_point<U>::value && !std::is_same<T, U>::value, int>::type = 0>
+C10_HOST_DEVICE c10::complex<decltype(T() + U())> pow(const c10::complex<T>& x, const U& y) {
+  using R = decltype(T() + U());
+  return std::pow(c10::complex<R>(x.real(), x.imag()), static_cast<R>(y));
+}
+
+template<typename T, typename U,
+         typename std::enable_if<std::is_floating_point<U>::value && !std::is_same<T, U>::value, int>::type = 0>
+C10_HOST_DEVICE c10::complex<decltype(T() + U())> pow(const U& x, const c10::complex<T>& y) {
+  using R = decltype(T() + U());
+  return std::pow(static_cast<R>(x), c10::complex<R>(y.real(), y.imag()));
+}
+
+template<typename T, typename U, typename std::enable_if<!std::is_same<T, U>::value, int>::type = 0>
+C10_HOST_DEVICE c10::complex<decltype(T() + U())> pow(const c10::complex<T>& x, const c10::complex<U>& y) {
+  using R = decltype(T() + U());
+  return std::pow(c10::complex<R>(x.real(), x.imag()), c10::complex<R>(y.real(), y.imag()));
+}
+
+// explicit instantiations, see [Header layout] in c10/util/complex_core.h
+#define C10_COMPLEX_MATH_INSTANTIATE(prefix, T) \
+  prefix template c10::complex<T> exp<T>(const c10::complex<T>&); \
+  prefix template c10::complex<T> log<T>(const c10::complex<T>&); \
+  prefix template c10::complex<T> pow<T>(const c10::complex<T>&, const c10::complex<T>&); \
+  prefix template c10::complex<T> pow<T>(const c10::complex<T>&, const T&); \
+  prefix template c10::complex<T> pow<T>(const T&, const c10::complex<T>&);
+
+#ifdef C10_COMPLEX_EXTERN_TEMPLATES_ENABLED
+C10_COMPLEX_MATH_INSTANTIATE(extern, float)
+C10_COMPLEX_MATH_INSTANTIATE(extern, double)
+#endif
+
+} // namespace std
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <c10/util/complex.h>
+#include <c10/util/parallel.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// [Complex polynomials]
+//
+// Polynomials are given by their ncoef coefficients in increasing order of degree:
+//   p(z) = c[0] + c[1] z + ... + c[ncoef - 1] z^(ncoef - 1)
+// The coefficients can be real (T) or complex (complex<T>).
+//
+// - polyval_horner / polyval_estrin: out[j] = p(z[j]) for many points. Both process the points
+//   a block at a time with the loop over points innermost, so that every step is an elementwise
+//   operation over the block that the compiler can vectorize. Horner takes ncoef - 1 dependent
+//   steps; Estrin takes log2(ncoef) steps of independent work, at the cost of some scratch memory
+//   and a few more multiplications, which is faster for high degrees.
+// - freqz: frequency response H(w) = B(exp(-iw)) / A(exp(-iw)) of a filter at n points w = pi k / n,
+//   k = 0, ..., n - 1, as in scipy.signal.freqz.
+// - roots: all roots of many polynomials at once, with the Aberth-Ehrlich iteration.
+
+namespace c10 {
+
+namespace detail {
+
+constexpr int64_t poly_block_size = 256;
+
+} // namespace detail
+
+template<typename C, typename T>
+void polyval_horner(const C* coeffs, int64_t ncoef, const complex<T>* z, complex<T>* out, int64_t n) {
+  C10_COMPLEX_KERNEL("c10::polyval_horner");
+  complex<T> acc[detail::poly_block_size];
+  for (int64_t begin = 0; begin < n; begin += detail::poly_block_size) {
+    const int64_t size = std::min(detail::poly_block_size, n - begin);
+    const complex<T>* x = z + begin;
+    for (int64_t j = 0; j < size; j++) {
+      acc[j] = ncoef > 0 ? complex<T>(coeffs[ncoef - 1]) : complex<T>();
+    }
+    for (int64_t k = ncoef - 2; k >= 0; k--) {
+      const C c = coeffs[k];
+      for (int64_t j = 0; j < size; j++) {
+        acc[j] = acc[j] * x[j] + c;
+      }
+    }
+    std::copy(acc, acc + size, out + begin);
+  }
+}
+
+template<typename C, typename T>
+void polyval_estrin(const C* coeffs, int64_t ncoef, const complex<T>* z, complex<T>* out, int64_t n) {
+  C10_COMPLEX_KERNEL("c10::polyval_estrin");
+  if (ncoef <= 1) {
+    std::fill(out, out + n, ncoef == 1 ? complex<T>(coeffs[0]) : complex<T>());
+    return;
+  }
+  constexpr int64_t block_size = detail::poly_block_size;
+  // terms[i * block_size + j] is the i-th partial polynomial at point j
+  std::vector<complex<T>> terms(((ncoef + 1) / 2) * block_size);
+  complex<T> power[block_size];
+  for (int64_t begin = 0; begin < n; begin += block_size) {
+    const int64_t size = std::min(block_size, n - begin);
+    const complex<T>* x = z + begin;
+    // first level: c[2i] + c[2i + 1] z
+    int64_t count = ncoef / 2;
+    for (int64_t i = 0; i < count; i++) {
+      const C c0 = coeffs[2 * i];
+      const C c1 = coeffs[2 * i + 1];
+      complex<T>* t = terms.data() + i * block_size;
+      for (int64_t j = 0; j < size; j++) {
+        t[j] = x[j] * c1 + c0;
+      }
+    }
+    if (ncoef % 2 == 1) {
+      complex<T>* t = terms.data() + count * block_size;
+      std::fill(t, t + size, complex<T>(coeffs[ncoef - 1]));
+      count++;
+    }
+    for (int64_t j = 0; j < size; j++) {
+      power[j] = x[j] * x[j];
+    }
+    // next levels: t[2i] + t[2i + 1] z^(2^level)
+    while (count > 1) {
+      const int64_t next = count / 2;
+      for (int64_t i = 0; i < next; i++) {
+        const complex<T>* t0 = terms.data() + 2 * i * block_size;
+        const complex<T>* t1 = t0 + block_size;
+        complex<T>* t = terms.data() + i * block_size;
+        for (int64_t j = 0; j < size; j++) {
+          t[j] = t1[j] * power[j] + t0[j];
+        }
+      }
+      if (count % 2 == 1) {
+        std::copy(terms.data() + (count - 1) * block_size, terms.data() + (count - 1) * block_size + size,
+                  terms.data() + next * block_size);
+      }
+      count = (count + 1) / 2;
+      if (count > 1) {
+        for (int64_t j = 0; j < size; j++) {
+          power[j] *= power[j];
+        }
+      }
+    }
+    std::copy(terms.data(), terms.data() + size, out + begin);
+  }
+}
+
+template<typename C, typename T>
+void freqz(const C* b, int64_t nb, const C* a, int64_t na, complex<T>* out, int64_t n) {
+  C10_COMPLEX_KERNEL("c10::freqz");
+  std::vector<complex<T>> z(n);
+  std::vector<complex<T>> denominator(n);
+  for (int64_t k = 0; k < n; k++) {
+    z[k] = polar(T(1), static_cast<T>(-3.141592653589793238463 * static_cast<double>(k) / static_cast<double>(n)));
+  }
+  polyval_horner(b, nb, z.data(), out, n);
+  polyval_horner(a, na, z.data(), denominator.data(), n);
+  for (int64_t k = 0; k < n; k++) {
+    out[k] /= denominator[k];
+  }
+}
+
+// Roots of batch polynomials of the same degree, with ncoef = degree + 1 coefficients each,
+// stored back to back. The roots of polynomial i are written to out[i * degree, (i + 1) * degree),
+// in no particular order. The leading coefficient must be nonzero.
+//
+// If info is not null, info[i] is set to 0 if the iteration for polynomial i converged, and to 1
+// if it did not converge in max_iterations, in which case the roots are the last approximations.
+template<typename T>
+void roots(const complex<T>* coeffs, int64_t degree, int64_t batch, complex<T>* out,
+           int32_t* info = nullptr, int max_iterations = 100) {
+  C10_COMPLEX_KERNEL("c10::roots");
+  if (degree <= 0) {
+    if (info != nullptr) {
+      std::fill(info, info + batch, 0);
+    }
+    return;
+  }
+  parallel_for(0, batch, 16, [&](int64_t begin, int64_t end) {
+    std::vector<complex<T>> correction(degree);
+    std::vector<char> done(degree);
+    for (int64_t b = begin; b < end; b++) {
+      const complex<T>* c = coeffs + b * (degree + 1);
+      complex<T>* z = out + b * degree;
+      // Initial guesses on a circle of radius |c[0] / c[degree]|^(1 / degree), which is the
+      // geometric mean of the moduli of the roots, at angles offset to avoid the real axis
+      const T lead = std::abs(c[degree]);
+      T radius = std::pow(std::abs(c[0]) / lead, T(1) / static_cast<T>(degree));
+      if (!(radius > T(0)) || !std::isfinite(radius)) {
+        radius = T(1);
+      }
+      for (int64_t k = 0; k < degree; k++) {
+        const T theta = static_cast<T>(6.283185307179586476925 * (static_cast<double>(k) + 0.25) / static_cast<double>(degree) + 0.4);
+        z[k] = polar(radius, theta);
+      }
+      // A root is final once |p(z_k)| is below the rounding error of evaluating p there,
+      // eps * sum |c_m| |z_k|^m, after which it no longer moves
+      std::fill(done.begin(), done.end(), 0);
+      int64_t remaining = degree;
+      for (int iteration = 0; iteration < max_iterations && remaining > 0; iteration++) {
+        for (int64_t k = 0; k < degree; k++) {
+          correction[k] = complex<T>();
+          if (done[k]) {
+            continue;
+          }
+          // p(z_k) and p'(z_k) by Horner, and the rounding error bound
+          complex<T> p = c[degree];
+          complex<T> dp;
+          T bound = std::abs(c[degree]);
+          const T abs_z = std::abs(z[k]);
+          for (int64_t m = degree - 1; m >= 0; m--) {
+            dp = dp * z[k] + p;
+            p = p * z[k] + c[m];
+            bound = bound * abs_z + std::abs(c[m]);
+          }
+          if (std::abs(p) <= 4 * std::numeric_limits<T>::epsilon() * bound) {
+            done[k] = 1;
+            remaining--;
+            continue;
+          }
+          const complex<T> ratio = p / dp;
+          complex<T> sum;
+          for (int64_t j = 0; j < degree; j++) {
+            if (j != k) {
+              sum += T(1) / (z[k] - z[j]);
+            }
+          }
+          correction[k] = ratio / (T(1) - ratio * sum);
+        }
+        for (int64_t k = 0; k < degree; k++) {
+          z[k] -= correction[k];
+        }
+      }
+      const int32_t status = remaining == 0 ? 0 : 1;
+      if (info != nullptr) {
+        info[b] = status;
+      }
+    }
+  });
+}
+
+// explicit instantiations, see [Header layout] in c10/util/complex_core.h
+#define C10_COMPLEX_POLY_INSTANTIATE(prefix, T) \
+  prefix template void polyval_horner<T, T>(const T*, int64_t, const complex<T>*, complex<T>*, int64_t); \
+  prefix template void polyval_horner<complex<T>, T>(const complex<T>*, int64_t, const complex<T>*, complex<T>*, int64_t); \
+  prefix template void polyval_estrin<T, T>(const T*, int64_t, const complex<T>*, complex<T>*, int64_t); \
+  prefix template void polyval_estrin<complex<T>, T>(const complex<T>*, int64_t, const complex<T>*, complex<T>*, int64_t); \
+  prefix template void freqz<T, T>(const T*, int64_t, const T*, int64_t, complex<T>*, int64_t); \
+  prefix template void freqz<complex<T>, T>(const complex<T>*, int64_t, const complex<T>*, int64_t, complex<T>*, int64_t); \
+  prefix template void roots<T>(const complex<T>*, int64_t, int64_t, complex<T>*, int32_t*, int);
+
+#ifdef C10_COMPLEX_EXTERN_TEMPLATES_ENABLED
+C10_COMPLEX_POLY_INSTANTIATE(extern, float)
+C10_COMPLEX_POLY_INSTANTIATE(extern, double)
+#endif
+
+} // namespace c10
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <c10/util/complex.h>
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+// [Batched pow]
+//
+// out[i] = pow(in[i], y) for a shared exponent y. in and out may be the same pointer.
+//
+// With an integer exponent, every element goes through the same sequence of squarings and
+// multiplications, so instead of running the loop of std::pow per element, the kernel walks
+// the bits of y once per block of elements and applies each step to the whole block. The inner
+// loops are then plain elementwise complex multiplications, which the compiler can vectorize.
+//
+// Real and complex exponents go through exp(y * log(x)) per element, see std::pow in
+// c10/util/complex_math.h. The precision is that of in: a double exponent is converted to float
+// for a complex<float> input, while only integral exponents take the integer path.
+
+namespace c10 {
+
+namespace detail {
+
+// T in a non-deduced context, so that the exponent converts to the precision of in
+template<typename T>
+struct identity {
+  using type = T;
+};
+
+} // namespace detail
+
+template<typename T, typename I,
+         typename std::enable_if<std::is_integral<I>::value && !std::is_same<I, bool>::value, int>::type = 0>
+void pow(const complex<T>* in, I y, complex<T>* out, int64_t n) {
+  C10_COMPLEX_KERNEL("c10::pow");
+  using U = typename std::make_unsigned<I>::type;
+  constexpr int64_t block_size = 256;
+  complex<T> base[block_size];
+  // y < 0, written so that it does not warn for unsigned I
+  const bool negative = y < I(1) && y != I(0);
+  const U abs_y = negative ? static_cast<U>(U(0) - static_cast<U>(y)) : static_cast<U>(y);
+  for (int64_t begin = 0; begin < n; begin += block_size) {
+    const int64_t size = std::min(block_size, n - begin);
+    const complex<T>* x = in + begin;
+    complex<T>* result = out + begin;
+    for (int64_t i = 0; i < size; i++) {
+      base[i] = x[i];
+      result[i] = complex<T>(T(1));
+    }
+    for (U bits = abs_y; bits != 0;) {
+      if (bits & 1u) {
+        for (int64_t i = 0; i < size; i++) {
+          result[i] *= base[i];
+        }
+      }
+      bits >>= 1;
+      if (bits != 0) {
+        for (int64_t i = 0; i < size; i++) {
+          base[i] *= base[i];
+        }
+      }
+    }
+    if (negative) {
+      for (int64_t i = 0; i < size; i++) {
+        result[i] = T(1) / result[i];
+      }
+    }
+  }
+}
+
+template<typename T>
+void pow(const complex<T>* in, const typename detail::identity<T>::type& y, complex<T>* out, int64_t n) {
+  C10_COMPLEX_KERNEL("c10::pow");
+  for (int64_t i = 0; i < n; i++) {
+    out[i] = std::pow(in[i], y);
+  }
+}
+
+template<typename T>
+void pow(const complex<T>* in, const typename detail::identity<complex<T>>::type& y, complex<T>* out, int64_t n) {
+  C10_COMPLEX_KERNEL("c10::pow");
+  for (int64_t i = 0; i < n; i++) {
+    out[i] = std::pow(in[i], y);
+  }
+}
+
+// explicit instantiations, see [Header layout] in c10/util/complex_core.h
+#define C10_COMPLEX_POW_INSTANTIATE(prefix, T) \
+  prefix template void pow<T, int>(const complex<T>*, int, complex<T>*, int64_t); \
+  prefix template void pow<T>(const complex<T>*, const T&, complex<T>*, int64_t); \
+  prefix template void pow<T>(const complex<T>*, const complex<T>&, complex<T>*, int64_t);
+
+#ifdef C10_COMPLEX_EXTERN_TEMPLATES_ENABLED
+C10_COMPLEX_POW_INSTANTIATE(extern, float)
+C10_COMPLEX_POW_INSTANTIATE(extern, double)
+#endif
+
+} // namespace c10
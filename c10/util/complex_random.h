@@ -0,0 +1,139 @@
+#pragma once
+
+#include <c10/util/complex.h>
+#include <c10/util/parallel.h>
+#include <cmath>
+#include <cstdint>
+
+// [Complex random number generation]
+//
+// randn fills a buffer with circularly symmetric complex Gaussian noise CN(0, stddev^2),
+// i.e. the real and imaginary parts are independent N(0, stddev^2 / 2).
+// rand_phasor fills a buffer with unit magnitude phasors whose phase is uniform in (0, 2 pi]:
+// it is 2 pi times the same (0, 1] uniform as the Box-Muller angle of randn.
+//
+// Both use the counter-based Philox4x32-10 generator, the same one used by PyTorch's CUDA
+// generator. Sample i of the stream (seed, offset) only depends on seed and offset + i, so the
+// output does not depend on how the buffer is split across threads, and a stream can be
+// generated piecewise by advancing offset by the number of samples already drawn.
+// Reference: J. K. Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC 2011
+//
+// Gaussian samples use the Box-Muller transform, which maps two uniforms to a complex sample
+// with c10::polar and has no rejection loop (unlike Ziggurat), so that it is branch free.
+
+namespace c10 {
+
+struct philox4x32 {
+  uint32_t value[4];
+
+  // Philox4x32-10 for the 128-bit counter (counter, subsequence) and the 64-bit key seed
+  C10_HOST_DEVICE philox4x32(uint64_t seed, uint64_t counter, uint64_t subsequence = 0) {
+    uint32_t key0 = static_cast<uint32_t>(seed);
+    uint32_t key1 = static_cast<uint32_t>(seed >> 32);
+    uint32_t c0 = static_cast<uint32_t>(counter);
+    uint32_t c1 = static_cast<uint32_t>(counter >> 32);
+    uint32_t c2 = static_cast<uint32_t>(subsequence);
+    uint32_t c3 = static_cast<uint32_t>(subsequence >> 32);
+    for (int round = 0; round < 10; round++) {
+      uint64_t product0 = static_cast<uint64_t>(0xD2511F53u) * c0;
+      uint64_t product1 = static_cast<uint64_t>(0xCD9E8D57u) * c2;
+      uint32_t hi0 = static_cast<uint32_t>(product0 >> 32);
+      uint32_t lo0 = static_cast<uint32_t>(product0);
+      uint32_t hi1 = static_cast<uint32_t>(product1 >> 32);
+      uint32_t lo1 = static_cast<uint32_t>(product1);
+      c0 = hi1 ^ c1 ^ key0;
+      c1 = lo1;
+      c2 = hi0 ^ c3 ^ key1;
+      c3 = lo0;
+      key0 += 0x9E3779B9u;
+      key1 += 0xBB67AE85u;
+    }
+    value[0] = c0;
+    value[1] = c1;
+    value[2] = c2;
+    value[3] = c3;
+  }
+};
+
+namespace detail {
+
+// uniform in (0, 1], so that it is safe to take the log
+C10_HOST_DEVICE inline float uniform_open_closed(uint32_t x) {
+  return static_cast<float>((x >> 8) + 1) * (1.0f / 16777216.0f);
+}
+
+C10_HOST_DEVICE inline double uniform_open_closed(uint32_t hi, uint32_t lo) {
+  uint64_t x = (static_cast<uint64_t>(hi) << 32) | lo;
+  return static_cast<double>((x >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+// Each Philox call gives 4 x 32 bits, which is 2 samples of complex<float>
+// and 1 sample of complex<double>.
+template<typename T>
+struct random_samples_per_call {
+  static constexpr int value = 2;
+};
+
+template<>
+struct random_samples_per_call<double> {
+  static constexpr int value = 1;
+};
+
+C10_HOST_DEVICE inline void random_uniform_pair(const philox4x32& bits, int lane, float& u1, float& u2) {
+  u1 = uniform_open_closed(bits.value[2 * lane]);
+  u2 = uniform_open_closed(bits.value[2 * lane + 1]);
+}
+
+C10_HOST_DEVICE inline void random_uniform_pair(const philox4x32& bits, int /*lane*/, double& u1, double& u2) {
+  u1 = uniform_open_closed(bits.value[0], bits.value[1]);
+  u2 = uniform_open_closed(bits.value[2], bits.value[3]);
+}
+
+constexpr double two_pi = 6.283185307179586476925;
+
+template<typename T, typename F>
+void random_fill(complex<T>* out, int64_t n, uint64_t seed, uint64_t offset, const F& transform) {
+  constexpr int per_call = random_samples_per_call<T>::value;
+  parallel_for(0, n, 16384, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end;) {
+      uint64_t index = offset + i;
+      philox4x32 bits(seed, index / per_call);
+      for (int lane = index % per_call; lane < per_call && i < end; lane++, i++) {
+        T u1, u2;
+        random_uniform_pair(bits, lane, u1, u2);
+        out[i] = transform(u1, u2);
+      }
+    }
+  });
+}
+
+} // namespace detail
+
+template<typename T>
+void randn(complex<T>* out, int64_t n, uint64_t seed, uint64_t offset = 0, T stddev = T(1)) {
+  C10_COMPLEX_KERNEL("c10::randn");
+  // Box-Muller for a complex sample with E|z|^2 = stddev^2: |z| = stddev * sqrt(-log(u1))
+  detail::random_fill(out, n, seed, offset, [stddev](T u1, T u2) {
+    return polar(stddev * std::sqrt(-std::log(u1)), static_cast<T>(detail::two_pi) * u2);
+  });
+}
+
+template<typename T>
+void rand_phasor(complex<T>* out, int64_t n, uint64_t seed, uint64_t offset = 0) {
+  C10_COMPLEX_KERNEL("c10::rand_phasor");
+  detail::random_fill(out, n, seed, offset, [](T, T u2) {
+    return polar(T(1), static_cast<T>(detail::two_pi) * u2);
+  });
+}
+
+// explicit instantiations, see [Header layout] in c10/util/complex_core.h
+#define C10_COMPLEX_RANDOM_INSTANTIATE(prefix, T) \
+  prefix template void randn<T>(complex<T>*, int64_t, uint64_t, uint64_t, T); \
+  prefix template void rand_phasor<T>(complex<T>*, int64_t, uint64_t, uint64_t);
+
+#ifdef C10_COMPLEX_EXTERN_TEMPLATES_ENABLED
+C10_COMPLEX_RANDOM_INSTANTIATE(extern, float)
+C10_COMPLEX_RANDOM_INSTANTIATE(extern, double)
+#endif
+
+} // namespace c10
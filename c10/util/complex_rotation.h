@@ -0,0 +1,203 @@
+#pragma once
+
+#include <c10/util/complex.h>
+#include <c10/util/complex_view.h>
+#include <c10/util/parallel.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// [Givens rotations and Householder reflectors]
+//
+// Givens rotations, with the conventions of BLAS crotg/csrot: a rotation is a real c and a
+// complex s with c^2 + |s|^2 = 1, acting on a pair (x, y) as
+//   x' =  c x + s y
+//   y' = -conj(s) x + c y
+// - rotg(a, b, c, s): generates the rotation that zeroes b, and overwrites a with r, so that
+//   the rotation maps (a, b) to (r, 0). c >= 0, and r has the phase of a. The computation is
+//   scaled by |a| + |b|, so that it does not overflow or underflow unless r does.
+// - rot(x, y, n, c, s): applies one rotation to the n pairs (x[i], y[i]), e.g. two matrix rows.
+// - rotg_batch / rot_batch: the same for batch independent rotations, where rotation k acts on
+//   the rows x + k * n and y + k * n.
+//
+// Householder reflectors, with the conventions of LAPACK zlarfg/zlarf: a reflector is
+// H = I - tau v v^H with v[0] = 1, and H is unitary but not Hermitian in general.
+// - householder(alpha, x, n, tau): generates the reflector with H^H (alpha, x) = (beta, 0) for
+//   a vector (alpha, x[0], ..., x[n - 2]) of length n. beta is real, and overwrites alpha; v[1:]
+//   overwrites x. tau = 0 (H = I) if x is zero and alpha is real.
+// - apply_householder(v, tau, x, n, count, stride): x_k = H x_k for the count vectors
+//   x_k = x + k * stride of length n, with the full v (including v[0] = 1). Pass conj(tau) to
+//   apply H^H instead.
+//
+// The kernels work on the real and imaginary parts through view_as_real, so the loops are
+// plain real arithmetic that the compiler can vectorize, and the dot products of
+// apply_householder are accumulated in 4 lanes. Batches are split across threads.
+
+namespace c10 {
+
+namespace detail {
+
+constexpr int64_t rotation_grain_size = 64;
+
+// sqrt(sum |x[i]|^2), scaled by the largest component so that it does not overflow or underflow
+template<typename T>
+T stable_norm(const complex<T>* x, int64_t n) {
+  const T* v = view_as_real(x);
+  T scale = T(0);
+  for (int64_t i = 0; i < 2 * n; i++) {
+    scale = std::max(scale, std::fabs(v[i]));
+  }
+  if (scale == T(0) || !std::isfinite(scale)) {
+    return scale;
+  }
+  const T inv = T(1) / scale;
+  T sum = T(0);
+  for (int64_t i = 0; i < 2 * n; i++) {
+    const T w = v[i] * inv;
+    sum += w * w;
+  }
+  return scale * std::sqrt(sum);
+}
+
+} // namespace detail
+
+template<typename T>
+C10_HOST_DEVICE void rotg(complex<T>& a, const complex<T>& b, T& c, complex<T>& s) {
+  const T abs_a = std::abs(a);
+  if (abs_a == T(0)) {
+    c = T(0);
+    s = complex<T>(T(1));
+    a = b;
+    return;
+  }
+  const T scale = abs_a + std::abs(b);
+  const T norm = scale * std::sqrt(std::norm(a / scale) + std::norm(b / scale));
+  const complex<T> alpha = a / abs_a;
+  c = abs_a / norm;
+  s = alpha * std::conj(b) / norm;
+  a = alpha * norm;
+}
+
+template<typename T>
+void rot(complex<T>* x, complex<T>* y, int64_t n, T c, const complex<T>& s) {
+  T* xv = view_as_real(x);
+  T* yv = view_as_real(y);
+  const T sr = s.real();
+  const T si = s.imag();
+  for (int64_t i = 0; i < n; i++) {
+    const T xr = xv[2 * i];
+    const T xi = xv[2 * i + 1];
+    const T yr = yv[2 * i];
+    const T yi = yv[2 * i + 1];
+    xv[2 * i] = c * xr + (sr * yr - si * yi);
+    xv[2 * i + 1] = c * xi + (sr * yi + si * yr);
+    yv[2 * i] = c * yr - (sr * xr + si * xi);
+    yv[2 * i + 1] = c * yi - (sr * xi - si * xr);
+  }
+}
+
+template<typename T>
+void rotg_batch(complex<T>* a, const complex<T>* b, T* c, complex<T>* s, int64_t batch) {
+  C10_COMPLEX_KERNEL("c10::rotg_batch");
+  for (int64_t k = 0; k < batch; k++) {
+    rotg(a[k], b[k], c[k], s[k]);
+  }
+}
+
+template<typename T>
+void rot_batch(complex<T>* x, complex<T>* y, int64_t n, const T* c, const complex<T>* s, int64_t batch) {
+  C10_COMPLEX_KERNEL("c10::rot_batch");
+  parallel_for(0, batch, std::max<int64_t>(1, detail::rotation_grain_size * 64 / std::max<int64_t>(n, 1)),
+               [&](int64_t begin, int64_t end) {
+    for (int64_t k = begin; k < end; k++) {
+      rot(x + k * n, y + k * n, n, c[k], s[k]);
+    }
+  });
+}
+
+template<typename T>
+void householder(complex<T>& alpha, complex<T>* x, int64_t n, complex<T>& tau) {
+  const T x_norm = n > 1 ? detail::stable_norm(x, n - 1) : T(0);
+  const T alpha_real = alpha.real();
+  const T alpha_imag = alpha.imag();
+  if (x_norm == T(0) && alpha_imag == T(0)) {
+    tau = complex<T>();
+    return;
+  }
+  // |(alpha, x)|, scaled like std::hypot
+  const T scale = std::max(std::max(std::fabs(alpha_real), std::fabs(alpha_imag)), x_norm);
+  const T r = alpha_real / scale;
+  const T i = alpha_imag / scale;
+  const T m = x_norm / scale;
+  const T norm = scale * std::sqrt(r * r + i * i + m * m);
+  // beta has the opposite sign of Re(alpha), so that alpha - beta does not cancel
+  const T beta = alpha_real >= T(0) ? -norm : norm;
+  tau = complex<T>((beta - alpha_real) / beta, -alpha_imag / beta);
+  const complex<T> inv = T(1) / (alpha - beta);
+  for (int64_t k = 0; k < n - 1; k++) {
+    x[k] *= inv;
+  }
+  alpha = complex<T>(beta);
+}
+
+template<typename T>
+void apply_householder(const complex<T>* v, const complex<T>& tau, complex<T>* x, int64_t n, int64_t count, int64_t stride) {
+  C10_COMPLEX_KERNEL("c10::apply_householder");
+  if (tau == complex<T>()) {
+    return;
+  }
+  const T* vv = view_as_real(v);
+  const T tr = tau.real();
+  const T ti = tau.imag();
+  parallel_for(0, count, std::max<int64_t>(1, detail::rotation_grain_size * 64 / std::max<int64_t>(n, 1)),
+               [&](int64_t begin, int64_t end) {
+    for (int64_t k = begin; k < end; k++) {
+      T* xv = view_as_real(x + k * stride);
+      // dot = v^H x
+      T dot_re[4] = {};
+      T dot_im[4] = {};
+      int64_t i = 0;
+      for (; i + 4 <= n; i += 4) {
+        for (int l = 0; l < 4; l++) {
+          const T vr = vv[2 * (i + l)];
+          const T vi = vv[2 * (i + l) + 1];
+          const T xr = xv[2 * (i + l)];
+          const T xi = xv[2 * (i + l) + 1];
+          dot_re[l] += vr * xr + vi * xi;
+          dot_im[l] += vr * xi - vi * xr;
+        }
+      }
+      for (; i < n; i++) {
+        dot_re[0] += vv[2 * i] * xv[2 * i] + vv[2 * i + 1] * xv[2 * i + 1];
+        dot_im[0] += vv[2 * i] * xv[2 * i + 1] - vv[2 * i + 1] * xv[2 * i];
+      }
+      const T dr = (dot_re[0] + dot_re[1]) + (dot_re[2] + dot_re[3]);
+      const T di = (dot_im[0] + dot_im[1]) + (dot_im[2] + dot_im[3]);
+      // x -= v * (tau * dot)
+      const T wr = tr * dr - ti * di;
+      const T wi = tr * di + ti * dr;
+      for (int64_t j = 0; j < n; j++) {
+        const T vr = vv[2 * j];
+        const T vi = vv[2 * j + 1];
+        xv[2 * j] -= vr * wr - vi * wi;
+        xv[2 * j + 1] -= vr * wi + vi * wr;
+      }
+    }
+  });
+}
+
+// explicit instantiations, see [Header layout] in c10/util/complex_core.h
+#define C10_COMPLEX_ROTATION_INSTANTIATE(prefix, T) \
+  prefix template void rotg<T>(complex<T>&, const complex<T>&, T&, complex<T>&); \
+  prefix template void rot<T>(complex<T>*, complex<T>*, int64_t, T, const complex<T>&); \
+  prefix template void rotg_batch<T>(complex<T>*, const complex<T>*, T*, complex<T>*, int64_t); \
+  prefix template void rot_batch<T>(complex<T>*, complex<T>*, int64_t, const T*, const complex<T>*, int64_t); \
+  prefix template void householder<T>(complex<T>&, complex<T>*, int64_t, complex<T>&); \
+  prefix template void apply_householder<T>(const complex<T>*, const complex<T>&, complex<T>*, int64_t, int64_t, int64_t);
+
+#ifdef C10_COMPLEX_EXTERN_TEMPLATES_ENABLED
+C10_COMPLEX_ROTATION_INSTANTIATE(extern, float)
+C10_COMPLEX_ROTATION_INSTANTIATE(extern, double)
+#endif
+
+} // namespace c10
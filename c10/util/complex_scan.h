@@ -0,0 +1,154 @@
+#pragma once
+
+#include <c10/util/complex.h>
+#include <c10/util/parallel.h>
+#include <cstdint>
+#include <vector>
+
+// [Complex scan]
+//
+// cumsum/cumprod compute inclusive scans: out[i] = in[0] op in[1] op ... op in[i]
+// cumsum_exclusive/cumprod_exclusive compute exclusive scans: out[0] is the identity
+// (0 or 1), and out[i] = in[0] op ... op in[i - 1]
+//
+// Inputs longer than one block are scanned with the two-pass blocked algorithm:
+// 1. reduce every block to its total, in parallel
+// 2. scan the block totals serially to get the carry-in of each block
+// 3. scan every block starting from its carry-in, in parallel
+// The block size is fixed, so the result does not depend on the number of threads.
+// The reduction in step 1 keeps several independent accumulators so that it can be
+// vectorized; the scan in step 3 is a dependency chain and stays scalar.
+//
+// in and out may be the same pointer.
+
+namespace c10 {
+
+namespace detail {
+
+constexpr int64_t scan_block_size = 4096;
+constexpr int scan_lanes = 4;
+
+template<typename T>
+struct scan_sum {
+  static constexpr complex<T> identity() {
+    return complex<T>(T(0), T(0));
+  }
+  static constexpr complex<T> combine(const complex<T>& a, const complex<T>& b) {
+    return a + b;
+  }
+};
+
+template<typename T>
+struct scan_prod {
+  static constexpr complex<T> identity() {
+    return complex<T>(T(1), T(0));
+  }
+  static constexpr complex<T> combine(const complex<T>& a, const complex<T>& b) {
+    return a * b;
+  }
+};
+
+template<typename Op, typename T>
+complex<T> scan_reduce_block(const complex<T>* in, int64_t n) {
+  complex<T> acc[scan_lanes];
+  for (int l = 0; l < scan_lanes; l++) {
+    acc[l] = Op::identity();
+  }
+  int64_t i = 0;
+  for (; i + scan_lanes <= n; i += scan_lanes) {
+    for (int l = 0; l < scan_lanes; l++) {
+      acc[l] = Op::combine(acc[l], in[i + l]);
+    }
+  }
+  for (; i < n; i++) {
+    acc[0] = Op::combine(acc[0], in[i]);
+  }
+  for (int l = 1; l < scan_lanes; l++) {
+    acc[0] = Op::combine(acc[0], acc[l]);
+  }
+  return acc[0];
+}
+
+template<typename Op, typename T>
+void scan_block(const complex<T>* in, complex<T>* out, int64_t n, complex<T> carry, bool exclusive) {
+  if (exclusive) {
+    for (int64_t i = 0; i < n; i++) {
+      complex<T> x = in[i];
+      out[i] = carry;
+      carry = Op::combine(carry, x);
+    }
+  } else {
+    for (int64_t i = 0; i < n; i++) {
+      carry = Op::combine(carry, in[i]);
+      out[i] = carry;
+    }
+  }
+}
+
+template<typename Op, typename T>
+void scan(const complex<T>* in, complex<T>* out, int64_t n, bool exclusive) {
+  if (n <= scan_block_size) {
+    scan_block<Op>(in, out, n, Op::identity(), exclusive);
+    return;
+  }
+  int64_t num_blocks = divup(n, scan_block_size);
+  std::vector<complex<T>> carry(num_blocks);
+  parallel_for(0, num_blocks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; b++) {
+      int64_t offset = b * scan_block_size;
+      carry[b] = scan_reduce_block<Op>(in + offset, std::min(scan_block_size, n - offset));
+    }
+  });
+  complex<T> acc = Op::identity();
+  for (int64_t b = 0; b < num_blocks; b++) {
+    complex<T> total = carry[b];
+    carry[b] = acc;
+    acc = Op::combine(acc, total);
+  }
+  parallel_for(0, num_blocks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; b++) {
+      int64_t offset = b * scan_block_size;
+      scan_block<Op>(in + offset, out + offset, std::min(scan_block_size, n - offset), carry[b], exclusive);
+    }
+  });
+}
+
+} // namespace detail
+
+template<typename T>
+void cumsum(const complex<T>* in, complex<T>* out, int64_t n) {
+  C10_COMPLEX_KERNEL("c10::cumsum");
+  detail::scan<detail::scan_sum<T>>(in, out, n, false);
+}
+
+template<typename T>
+void cumsum_exclusive(const complex<T>* in, complex<T>* out, int64_t n) {
+  C10_COMPLEX_KERNEL("c10::cumsum_exclusive");
+  detail::scan<detail::scan_sum<T>>(in, out, n, true);
+}
+
+template<typename T>
+void cumprod(const complex<T>* in, complex<T>* out, int64_t n) {
+  C10_COMPLEX_KERNEL("c10::cumprod");
+  detail::scan<detail::scan_prod<T>>(in, out, n, false);
+}
+
+template<typename T>
+void cumprod_exclusive(const complex<T>* in, complex<T>* out, int64_t n) {
+  C10_COMPLEX_KERNEL("c10::cumprod_exclusive");
+  detail::scan<detail::scan_prod<T>>(in, out, n, true);
+}
+
+// explicit instantiations, see [Header layout] in c10/util/complex_core.h
+#define C10_COMPLEX_SCAN_INSTANTIATE(prefix, T) \
+  prefix template void cumsum<T>(const complex<T>*, complex<T>*, int64_t); \
+  prefix template void cumsum_exclusive<T>(const complex<T>*, complex<T>*, int64_t); \
+  prefix template void cumprod<T>(const complex<T>*, complex<T>*, int64_t); \
+  prefix template void cumprod_exclusive<T>(const complex<T>*, complex<T>*, int64_t);
+
+#ifdef C10_COMPLEX_EXTERN_TEMPLATES_ENABLED
+C10_COMPLEX_SCAN_INSTANTIATE(extern, float)
+C10_COMPLEX_SCAN_INSTANTIATE(extern, double)
+#endif
+
+} // namespace c10
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <c10/util/complex.h>
+#include <c10/util/parallel.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// [Selection by magnitude]
+//
+// Kernels to find the largest elements of a complex array by magnitude. They all compare
+// std::norm(z) = |z|^2 instead of std::abs(z), which does not need a hypot per element. It
+// orders elements the same way as long as |z|^2 does not overflow: all the elements with
+// |z| > sqrt(max) (about 1.8e19 for float, 1.3e154 for double) have an infinite norm, so they
+// tie and are ranked by index.
+//
+// - argmax_abs: index of the element with the largest magnitude, or -1 if n == 0. Elements whose
+//   norm is NaN are skipped, and if all of them are NaN the result is 0.
+// - topk_abs: indices of the k elements with the largest magnitudes, largest first. Elements
+//   whose norm is NaN are ranked after all the others, so they are only returned when there are
+//   fewer than k other elements.
+// - threshold_abs: indices of the elements with |x| > threshold, in increasing order. A negative
+//   threshold throws std::invalid_argument.
+// - cfar_abs: cell averaging CFAR detector, indices of the cells whose power is above scale
+//   times the mean power of the training cells around them, in increasing order
+//
+// Ties are broken by the smaller index, so the results do not depend on the number of threads.
+// The array is split into chunks that are processed in parallel and merged at the end. Within
+// a chunk, the norms are computed a block at a time into a small buffer, in a loop that the
+// compiler can vectorize, and the comparisons run over that buffer.
+
+namespace c10 {
+
+namespace detail {
+
+constexpr int64_t select_block_size = 256;
+constexpr int64_t select_grain_size = 32768;
+
+// calls f(offset, norms, size) for every block of [begin, end), with norms[j] = |x[offset + j]|^2
+template<typename T, typename F>
+void for_each_norm_block(const complex<T>* x, int64_t begin, int64_t end, const F& f) {
+  T norms[select_block_size];
+  for (int64_t offset = begin; offset < end; offset += select_block_size) {
+    const int64_t size = std::min(select_block_size, end - offset);
+    for (int64_t j = 0; j < size; j++) {
+      norms[j] = std::norm(x[offset + j]);
+    }
+    f(offset, norms, size);
+  }
+}
+
+// ordering for (norm, index) pairs: larger norm first, then smaller index. NaN norms come after
+// all the others, so that it stays a strict weak ordering for std::push_heap and std::partial_sort.
+template<typename T>
+bool select_before(const std::pair<T, int64_t>& a, const std::pair<T, int64_t>& b) {
+  const bool a_nan = std::isnan(a.first);
+  const bool b_nan = std::isnan(b.first);
+  if (a_nan != b_nan) {
+    return b_nan;
+  }
+  if (!a_nan && a.first != b.first) {
+    return a.first > b.first;
+  }
+  return a.second < b.second;
+}
+
+// appends the indices of the chunks' results in order
+inline void concat_chunks(const std::vector<std::vector<int64_t>>& chunks, int64_t* indices, int64_t& count) {
+  count = 0;
+  for (const auto& chunk : chunks) {
+    std::copy(chunk.begin(), chunk.end(), indices + count);
+    count += static_cast<int64_t>(chunk.size());
+  }
+}
+
+} // namespace detail
+
+template<typename T>
+int64_t argmax_abs(const complex<T>* x, int64_t n) {
+  C10_COMPLEX_KERNEL("c10::argmax_abs");
+  if (n <= 0) {
+    return -1;
+  }
+  const int64_t num_chunks = divup(n, detail::select_grain_size);
+  std::vector<std::pair<T, int64_t>> best(num_chunks, std::make_pair(T(-1), int64_t(-1)));
+  parallel_for(0, num_chunks, 1, [&](int64_t chunk_begin, int64_t chunk_end) {
+    for (int64_t c = chunk_begin; c < chunk_end; c++) {
+      // seeded with the first index of the chunk, which is kept if all of its norms are NaN
+      T best_norm = T(-1);
+      int64_t best_index = c * detail::select_grain_size;
+      const int64_t end = std::min(n, (c + 1) * detail::select_grain_size);
+      detail::for_each_norm_block(x, c * detail::select_grain_size, end, [&](int64_t offset, const T* norms, int64_t size) {
+        for (int64_t j = 0; j < size; j++) {
+          if (norms[j] > best_norm) {
+            best_norm = norms[j];
+            best_index = offset + j;
+          }
+        }
+      });
+      best[c] = std::make_pair(best_norm, best_index);
+    }
+  });
+  auto result = best[0];
+  for (int64_t c = 1; c < num_chunks; c++) {
+    if (detail::select_before(best[c], result)) {
+      result = best[c];
+    }
+  }
+  return result.second;
+}
+
+// indices must have room for min(k, n) elements; returns min(k, n)
+template<typename T>
+int64_t topk_abs(const complex<T>* x, int64_t n, int64_t k, int64_t* indices) {
+  C10_COMPLEX_KERNEL("c10::topk_abs");
+  k = std::max<int64_t>(0, std::min(k, n));
+  if (k == 0) {
+    return 0;
+  }
+  using entry = std::pair<T, int64_t>;
+  const auto before = [](const entry& a, const entry& b) { return detail::select_before(a, b); };
+  const int64_t num_chunks = divup(n, detail::select_grain_size);
+  std::vector<std::vector<entry>> candidates(num_chunks);
+  parallel_for(0, num_chunks, 1, [&](int64_t chunk_begin, int64_t chunk_end) {
+    for (int64_t c = chunk_begin; c < chunk_end; c++) {
+      // heap of the best k entries so far, with the worst one on top
+      std::vector<entry>& heap = candidates[c];
+      heap.reserve(k);
+      const int64_t end = std::min(n, (c + 1) * detail::select_grain_size);
+      detail::for_each_norm_block(x, c * detail::select_grain_size, end, [&](int64_t offset, const T* norms, int64_t size) {
+        for (int64_t j = 0; j < size; j++) {
+          const entry e(norms[j], offset + j);
+          if (static_cast<int64_t>(heap.size()) < k) {
+            heap.push_back(e);
+            std::push_heap(heap.begin(), heap.end(), before);
+          } else if (before(e, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), before);
+            heap.back() = e;
+            std::push_heap(heap.begin(), heap.end(), before);
+          }
+        }
+      });
+    }
+  });
+  std::vector<entry> merged;
+  merged.reserve(num_chunks * k);
+  for (const auto& chunk : candidates) {
+    merged.insert(merged.end(), chunk.begin(), chunk.end());
+  }
+  std::partial_sort(merged.begin(), merged.begin() + k, merged.end(), before);
+  for (int64_t i = 0; i < k; i++) {
+    indices[i] = merged[i].second;
+  }
+  return k;
+}
+
+// indices must have room for n elements; returns the number of indices written
+template<typename T>
+int64_t threshold_abs(const complex<T>* x, int64_t n, T threshold, int64_t* indices) {
+  C10_COMPLEX_KERNEL("c10::threshold_abs");
+  if (threshold < T(0)) {
+    throw std::invalid_argument("threshold_abs: threshold must not be negative");
+  }
+  const T threshold_norm = threshold * threshold;
+  const int64_t num_chunks = divup(n, detail::select_grain_size);
+  std::vector<std::vector<int64_t>> found(num_chunks);
+  parallel_for(0, num_chunks, 1, [&](int64_t chunk_begin, int64_t chunk_end) {
+    for (int64_t c = chunk_begin; c < chunk_end; c++) {
+      const int64_t end = std::min(n, (c + 1) * detail::select_grain_size);
+      detail::for_each_norm_block(x, c * detail::select_grain_size, end, [&](int64_t offset, const T* norms, int64_t size) {
+        for (int64_t j = 0; j < size; j++) {
+          if (norms[j] > threshold_norm) {
+            found[c].push_back(offset + j);
+          }
+        }
+      });
+    }
+  });
+  int64_t count;
+  detail::concat_chunks(found, indices, count);
+  return count;
+}
+
+// Cell averaging CFAR: cell i is detected if |x[i]|^2 > scale * noise(i), where noise(i) is the
+// mean of |x[j]|^2 over the training cells guard < |j - i| <= guard + train that are inside the
+// array. Cells without any training cell are never detected.
+// indices must have room for n elements; returns the number of indices written.
+template<typename T>
+int64_t cfar_abs(const complex<T>* x, int64_t n, int64_t guard, int64_t train, T scale, int64_t* indices) {
+  C10_COMPLEX_KERNEL("c10::cfar_abs");
+  // Sliding sums are accumulated in double, so that float inputs do not drift
+  std::vector<double> power(n);
+  parallel_for(0, n, detail::select_grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      power[i] = static_cast<double>(std::norm(x[i]));
+    }
+  });
+  const int64_t num_chunks = divup(n, detail::select_grain_size);
+  std::vector<std::vector<int64_t>> found(num_chunks);
+  parallel_for(0, num_chunks, 1, [&](int64_t chunk_begin, int64_t chunk_end) {
+    for (int64_t c = chunk_begin; c < chunk_end; c++) {
+      const int64_t begin = c * detail::select_grain_size;
+      const int64_t end = std::min(n, begin + detail::select_grain_size);
+      // sums over the clipped windows [i - guard - train, i - guard) and (i + guard, i + guard + train],
+      // initialized at begin, and then moved by one cell per step
+      double left = 0;
+      double right = 0;
+      for (int64_t j = std::max<int64_t>(0, begin - guard - train); j < std::max<int64_t>(0, begin - guard); j++) {
+        left += power[j];
+      }
+      for (int64_t j = begin + guard + 1; j <= std::min(n - 1, begin + guard + train); j++) {
+        right += power[j];
+      }
+      for (int64_t i = begin; i < end; i++) {
+        const int64_t left_count = std::max<int64_t>(0, std::min(train, i - guard));
+        const int64_t right_count = std::max<int64_t>(0, std::min(train, n - 1 - i - guard));
+        const int64_t count = left_count + right_count;
+        if (count > 0 && power[i] > static_cast<double>(scale) * (left + right) / static_cast<double>(count)) {
+          found[c].push_back(i);
+        }
+        // slide to i + 1
+        if (i - guard >= 0) {
+          left += power[i - guard];
+        }
+        if (i - guard - train >= 0) {
+          left -= power[i - guard - train];
+        }
+        if (i + guard + 1 < n) {
+          right -= power[i + guard + 1];
+        }
+        if (i + guard + train + 1 < n) {
+          right += power[i + guard + train + 1];
+        }
+      }
+    }
+  });
+  int64_t count;
+  detail::concat_chunks(found, indices, count);
+  return count;
+}
+
+// explicit instantiations, see [Header layout] in c10/util/complex_core.h
+#define C10_COMPLEX_SELECT_INSTANTIATE(prefix, T) \
+  prefix template int64_t argmax_abs<T>(const complex<T>*, int64_t); \
+  prefix template int64_t topk_abs<T>(const complex<T>*, int64_t, int64_t, int64_t*); \
+  prefix template int64_t threshold_abs<T>(const complex<T>*, int64_t, T, int64_t*); \
+  prefix template int64_t cfar_abs<T>(const complex<T>*, int64_t, int64_t, int64_t, T, int64_t*);
+
+#ifdef C10_COMPLEX_EXTERN_TEMPLATES_ENABLED
+C10_COMPLEX_SELECT_INSTANTIATE(extern, float)
+C10_COMPLEX_SELECT_INSTANTIATE(extern, double)
+#endif
+
+} // namespace c10
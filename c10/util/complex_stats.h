@@ -0,0 +1,489 @@
+#pragma once
+
+#include <c10/util/complex.h>
+#include <c10/util/complex_fast_math.h>
+#include <c10/util/complex_view.h>
+#include <c10/util/parallel.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+// [Streaming statistics]
+//
+// Single pass accumulators for complex data, which can be updated with one sample or a whole
+// buffer at a time, and merged, e.g. to combine the statistics of several capture buffers or
+// of several channels.
+//
+// - moments: count, mean, variance E|x - mean|^2, pseudo variance E(x - mean)^2 and power
+//   E|x|^2. The variance and pseudo variance are the covariance and pseudo covariance of x with
+//   itself; together they give the 2x2 covariance of the real and imaginary parts:
+//     var(re) = (variance + Re pseudo) / 2, var(im) = (variance - Re pseudo) / 2,
+//     cov(re, im) = Im pseudo / 2
+// - cross_moments: the same for a pair of signals, with covariance E(x - mean_x) conj(y - mean_y)
+//   and pseudo covariance E(x - mean_x)(y - mean_y).
+// - magnitude_histogram: counts of |x| in bins of equal width on [0, max_magnitude).
+// - phase_histogram: counts of arg(x) in bins of equal width on [-pi, pi], the last bin also
+//   holding pi.
+//
+// The moments are kept as means and sums of squared deviations, as in Welford's algorithm, and
+// two accumulators are merged with the update of Chan et al., so there is no cancellation like
+// in E|x|^2 - |E x|^2. update(x, n) computes the moments of fixed size blocks of the buffer in
+// parallel, with two passes over each block while it is in cache, and merges them in order, so
+// the result does not depend on the number of threads. update(x) for one sample is Welford's
+// update.
+//
+// The histograms do not call std::abs or std::arg: bins are found from sqrt(norm(x)) and from
+// the polynomial atan2 of c10::fast, a block at a time in loops that the compiler can
+// vectorize. An element within a few ulps of a bin edge may therefore land in the neighboring
+// bin. Elements that fall in no bin (|x| >= max_magnitude, norm(x) overflowing, or NaN parts
+// for magnitudes; infinite or NaN parts for phases) are counted by discarded().
+
+namespace c10 {
+
+namespace detail {
+
+constexpr int64_t stats_block_size = 4096;
+constexpr int64_t histogram_block_size = 256;
+constexpr int64_t histogram_grain_size = 32768;
+constexpr double histogram_pi = 3.141592653589793238463;
+
+// counts, chunk by chunk in parallel, the elements whose position (as computed a block at a
+// time by position(block, size, out)) is in [0, bins)
+template<typename T, typename F>
+void histogram_update(const complex<T>* x, int64_t n, std::vector<int64_t>& counts, int64_t& discarded, const F& position) {
+  const int64_t bins = static_cast<int64_t>(counts.size());
+  const int64_t num_chunks = divup(n, histogram_grain_size);
+  std::vector<std::vector<int64_t>> chunk_counts(num_chunks);
+  std::vector<int64_t> chunk_discarded(num_chunks);
+  parallel_for(0, num_chunks, 1, [&](int64_t chunk_begin, int64_t chunk_end) {
+    T positions[histogram_block_size];
+    for (int64_t c = chunk_begin; c < chunk_end; c++) {
+      std::vector<int64_t>& local = chunk_counts[c];
+      local.assign(bins, 0);
+      int64_t outside = 0;
+      const int64_t end = std::min(n, (c + 1) * histogram_grain_size);
+      for (int64_t offset = c * histogram_grain_size; offset < end; offset += histogram_block_size) {
+        const int64_t size = std::min(histogram_block_size, end - offset);
+        position(x + offset, size, positions);
+        for (int64_t j = 0; j < size; j++) {
+          if (positions[j] >= T(0) && positions[j] < static_cast<T>(bins)) {
+            local[static_cast<int64_t>(positions[j])]++;
+          } else {
+            outside++;
+          }
+        }
+      }
+      chunk_discarded[c] = outside;
+    }
+  });
+  for (int64_t c = 0; c < num_chunks; c++) {
+    for (int64_t k = 0; k < bins; k++) {
+      counts[k] += chunk_counts[c][k];
+    }
+    discarded += chunk_discarded[c];
+  }
+}
+
+// atan2 through the polynomial of c10::fast, which is branch free and vectorizes
+inline float histogram_atan2(float y, float x) {
+  return fast::detail::atan2(y, x);
+}
+
+// normalized first, so that the float atan2 neither overflows nor underflows
+inline float histogram_atan2(double y, double x) {
+  const double h = std::max(std::fabs(x), std::fabs(y));
+  const double inv = h > 0.0 ? 1.0 / h : 1.0;
+  return fast::detail::atan2(static_cast<float>(y * inv), static_cast<float>(x * inv));
+}
+
+} // namespace detail
+
+template<typename T>
+class moments {
+ public:
+  void update(const complex<T>& x) {
+    count_++;
+    const complex<T> delta = x - mean_;
+    mean_ += delta / static_cast<T>(count_);
+    const complex<T> delta_new = x - mean_;
+    m2_ += delta.real() * delta_new.real() + delta.imag() * delta_new.imag();
+    m2_pseudo_ += delta * delta_new;
+  }
+
+  void update(const complex<T>* x, int64_t n) {
+    C10_COMPLEX_KERNEL("c10::moments::update");
+    const int64_t num_blocks = divup(n, detail::stats_block_size);
+    std::vector<moments> partial(num_blocks);
+    parallel_for(0, num_blocks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t b = begin; b < end; b++) {
+        const int64_t offset = b * detail::stats_block_size;
+        partial[b] = of_block(x + offset, std::min(detail::stats_block_size, n - offset));
+      }
+    });
+    for (const moments& block : partial) {
+      merge(block);
+    }
+  }
+
+  void merge(const moments& other) {
+    if (other.count_ == 0) {
+      return;
+    }
+    if (count_ == 0) {
+      *this = other;
+      return;
+    }
+    const int64_t count = count_ + other.count_;
+    const complex<T> delta = other.mean_ - mean_;
+    const T weight = static_cast<T>(count_) * static_cast<T>(other.count_) / static_cast<T>(count);
+    mean_ += delta * (static_cast<T>(other.count_) / static_cast<T>(count));
+    m2_ += other.m2_ + std::norm(delta) * weight;
+    m2_pseudo_ += other.m2_pseudo_ + delta * delta * weight;
+    count_ = count;
+  }
+
+  int64_t count() const {
+    return count_;
+  }
+
+  complex<T> mean() const {
+    return mean_;
+  }
+
+  // divides by count() - ddof, ddof = 1 gives the unbiased estimate
+  T variance(int64_t ddof = 0) const {
+    return m2_ / static_cast<T>(count_ - ddof);
+  }
+
+  complex<T> pseudo_variance(int64_t ddof = 0) const {
+    return m2_pseudo_ / static_cast<T>(count_ - ddof);
+  }
+
+  // E|x|^2
+  T power() const {
+    return variance() + std::norm(mean_);
+  }
+
+ private:
+  static moments of_block(const complex<T>* x, int64_t n) {
+    const T* v = view_as_real(x);
+    T sum_re[4] = {};
+    T sum_im[4] = {};
+    int64_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      for (int l = 0; l < 4; l++) {
+        sum_re[l] += v[2 * (i + l)];
+        sum_im[l] += v[2 * (i + l) + 1];
+      }
+    }
+    for (; i < n; i++) {
+      sum_re[0] += v[2 * i];
+      sum_im[0] += v[2 * i + 1];
+    }
+    const T inv = T(1) / static_cast<T>(n);
+    const T mean_re = ((sum_re[0] + sum_re[1]) + (sum_re[2] + sum_re[3])) * inv;
+    const T mean_im = ((sum_im[0] + sum_im[1]) + (sum_im[2] + sum_im[3])) * inv;
+    // sum |x - mean|^2 and sum (x - mean)^2
+    T m2[4] = {};
+    T pseudo_re[4] = {};
+    T pseudo_im[4] = {};
+    for (i = 0; i + 4 <= n; i += 4) {
+      for (int l = 0; l < 4; l++) {
+        const T dr = v[2 * (i + l)] - mean_re;
+        const T di = v[2 * (i + l) + 1] - mean_im;
+        m2[l] += dr * dr + di * di;
+        pseudo_re[l] += dr * dr - di * di;
+        pseudo_im[l] += dr * di;
+      }
+    }
+    for (; i < n; i++) {
+      const T dr = v[2 * i] - mean_re;
+      const T di = v[2 * i + 1] - mean_im;
+      m2[0] += dr * dr + di * di;
+      pseudo_re[0] += dr * dr - di * di;
+      pseudo_im[0] += dr * di;
+    }
+    moments result;
+    result.count_ = n;
+    result.mean_ = complex<T>(mean_re, mean_im);
+    result.m2_ = (m2[0] + m2[1]) + (m2[2] + m2[3]);
+    result.m2_pseudo_ = complex<T>((pseudo_re[0] + pseudo_re[1]) + (pseudo_re[2] + pseudo_re[3]),
+                                   T(2) * ((pseudo_im[0] + pseudo_im[1]) + (pseudo_im[2] + pseudo_im[3])));
+    return result;
+  }
+
+  int64_t count_ = 0;
+  complex<T> mean_;
+  T m2_ = T(0);
+  complex<T> m2_pseudo_;
+};
+
+template<typename T>
+class cross_moments {
+ public:
+  void update(const complex<T>& x, const complex<T>& y) {
+    count_++;
+    const complex<T> delta_x = x - mean_x_;
+    mean_x_ += delta_x / static_cast<T>(count_);
+    mean_y_ += (y - mean_y_) / static_cast<T>(count_);
+    const complex<T> delta_y = y - mean_y_;
+    c2_ += delta_x * std::conj(delta_y);
+    c2_pseudo_ += delta_x * delta_y;
+  }
+
+  void update(const complex<T>* x, const complex<T>* y, int64_t n) {
+    C10_COMPLEX_KERNEL("c10::cross_moments::update");
+    const int64_t num_blocks = divup(n, detail::stats_block_size);
+    std::vector<cross_moments> partial(num_blocks);
+    parallel_for(0, num_blocks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t b = begin; b < end; b++) {
+        const int64_t offset = b * detail::stats_block_size;
+        partial[b] = of_block(x + offset, y + offset, std::min(detail::stats_block_size, n - offset));
+      }
+    });
+    for (const cross_moments& block : partial) {
+      merge(block);
+    }
+  }
+
+  void merge(const cross_moments& other) {
+    if (other.count_ == 0) {
+      return;
+    }
+    if (count_ == 0) {
+      *this = other;
+      return;
+    }
+    const int64_t count = count_ + other.count_;
+    const complex<T> delta_x = other.mean_x_ - mean_x_;
+    const complex<T> delta_y = other.mean_y_ - mean_y_;
+    const T weight = static_cast<T>(count_) * static_cast<T>(other.count_) / static_cast<T>(count);
+    const T fraction = static_cast<T>(other.count_) / static_cast<T>(count);
+    mean_x_ += delta_x * fraction;
+    mean_y_ += delta_y * fraction;
+    c2_ += other.c2_ + delta_x * std::conj(delta_y) * weight;
+    c2_pseudo_ += other.c2_pseudo_ + delta_x * delta_y * weight;
+    count_ = count;
+  }
+
+  int64_t count() const {
+    return count_;
+  }
+
+  complex<T> mean_x() const {
+    return mean_x_;
+  }
+
+  complex<T> mean_y() const {
+    return mean_y_;
+  }
+
+  // E(x - mean_x) conj(y - mean_y), divided by count() - ddof
+  complex<T> covariance(int64_t ddof = 0) const {
+    return c2_ / static_cast<T>(count_ - ddof);
+  }
+
+  // E(x - mean_x)(y - mean_y), divided by count() - ddof
+  complex<T> pseudo_covariance(int64_t ddof = 0) const {
+    return c2_pseudo_ / static_cast<T>(count_ - ddof);
+  }
+
+ private:
+  static cross_moments of_block(const complex<T>* x, const complex<T>* y, int64_t n) {
+    const T* xv = view_as_real(x);
+    const T* yv = view_as_real(y);
+    T sum[4][4] = {};
+    int64_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      for (int l = 0; l < 4; l++) {
+        sum[0][l] += xv[2 * (i + l)];
+        sum[1][l] += xv[2 * (i + l) + 1];
+        sum[2][l] += yv[2 * (i + l)];
+        sum[3][l] += yv[2 * (i + l) + 1];
+      }
+    }
+    for (; i < n; i++) {
+      sum[0][0] += xv[2 * i];
+      sum[1][0] += xv[2 * i + 1];
+      sum[2][0] += yv[2 * i];
+      sum[3][0] += yv[2 * i + 1];
+    }
+    const T inv = T(1) / static_cast<T>(n);
+    T mean[4];
+    for (int k = 0; k < 4; k++) {
+      mean[k] = ((sum[k][0] + sum[k][1]) + (sum[k][2] + sum[k][3])) * inv;
+    }
+    // sum a conj(b) and sum a b, with a = x - mean_x and b = y - mean_y
+    T c2_re[4] = {};
+    T c2_im[4] = {};
+    T pseudo_re[4] = {};
+    T pseudo_im[4] = {};
+    const auto accumulate = [&](int64_t j, int l) {
+      const T ar = xv[2 * j] - mean[0];
+      const T ai = xv[2 * j + 1] - mean[1];
+      const T br = yv[2 * j] - mean[2];
+      const T bi = yv[2 * j + 1] - mean[3];
+      c2_re[l] += ar * br + ai * bi;
+      c2_im[l] += ai * br - ar * bi;
+      pseudo_re[l] += ar * br - ai * bi;
+      pseudo_im[l] += ar * bi + ai * br;
+    };
+    for (i = 0; i + 4 <= n; i += 4) {
+      for (int l = 0; l < 4; l++) {
+        accumulate(i + l, l);
+      }
+    }
+    for (; i < n; i++) {
+      accumulate(i, 0);
+    }
+    const auto reduce = [](const T* lanes) {
+      return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    };
+    cross_moments result;
+    result.count_ = n;
+    result.mean_x_ = complex<T>(mean[0], mean[1]);
+    result.mean_y_ = complex<T>(mean[2], mean[3]);
+    result.c2_ = complex<T>(reduce(c2_re), reduce(c2_im));
+    result.c2_pseudo_ = complex<T>(reduce(pseudo_re), reduce(pseudo_im));
+    return result;
+  }
+
+  int64_t count_ = 0;
+  complex<T> mean_x_;
+  complex<T> mean_y_;
+  complex<T> c2_;
+  complex<T> c2_pseudo_;
+};
+
+template<typename T>
+class magnitude_histogram {
+ public:
+  magnitude_histogram(int64_t bins, T max_magnitude)
+    : max_magnitude_(max_magnitude), counts_(std::max<int64_t>(bins, 0)) {
+    if (bins <= 0 || !(max_magnitude > T(0))) {
+      throw std::invalid_argument("magnitude_histogram: bins and max_magnitude must be positive");
+    }
+  }
+
+  void update(const complex<T>* x, int64_t n) {
+    C10_COMPLEX_KERNEL("c10::magnitude_histogram::update");
+    const T scale = static_cast<T>(bins()) / max_magnitude_;
+    detail::histogram_update(x, n, counts_, discarded_, [scale](const complex<T>* block, int64_t size, T* out) {
+      const T* v = view_as_real(block);
+      for (int64_t j = 0; j < size; j++) {
+        out[j] = std::sqrt(v[2 * j] * v[2 * j] + v[2 * j + 1] * v[2 * j + 1]) * scale;
+      }
+    });
+  }
+
+  void merge(const magnitude_histogram& other) {
+    if (other.bins() != bins() || other.max_magnitude_ != max_magnitude_) {
+      throw std::invalid_argument("magnitude_histogram: cannot merge histograms with different bins");
+    }
+    for (int64_t k = 0; k < bins(); k++) {
+      counts_[k] += other.counts_[k];
+    }
+    discarded_ += other.discarded_;
+  }
+
+  int64_t bins() const {
+    return static_cast<int64_t>(counts_.size());
+  }
+
+  T max_magnitude() const {
+    return max_magnitude_;
+  }
+
+  // lower edge of bin k, bin_edge(bins()) is max_magnitude()
+  T bin_edge(int64_t k) const {
+    return max_magnitude_ * static_cast<T>(k) / static_cast<T>(bins());
+  }
+
+  const std::vector<int64_t>& counts() const {
+    return counts_;
+  }
+
+  int64_t discarded() const {
+    return discarded_;
+  }
+
+ private:
+  T max_magnitude_;
+  std::vector<int64_t> counts_;
+  int64_t discarded_ = 0;
+};
+
+template<typename T>
+class phase_histogram {
+ public:
+  explicit phase_histogram(int64_t bins) : counts_(std::max<int64_t>(bins, 0)) {
+    if (bins <= 0) {
+      throw std::invalid_argument("phase_histogram: bins must be positive");
+    }
+  }
+
+  void update(const complex<T>* x, int64_t n) {
+    C10_COMPLEX_KERNEL("c10::phase_histogram::update");
+    const T scale = static_cast<T>(bins()) / static_cast<T>(2 * detail::histogram_pi);
+    const T last = static_cast<T>(bins()) - T(0.5);
+    const T pi = static_cast<T>(detail::histogram_pi);
+    detail::histogram_update(x, n, counts_, discarded_, [scale, last, pi](const complex<T>* block, int64_t size, T* out) {
+      const T* v = view_as_real(block);
+      for (int64_t j = 0; j < size; j++) {
+        const T re = v[2 * j];
+        const T im = v[2 * j + 1];
+        // 0 for finite parts and NaN otherwise, as fast::detail::atan2 does not propagate NaN
+        const T check = re * T(0) + im * T(0);
+        // phase = pi goes in the last bin
+        out[j] = std::min((static_cast<T>(detail::histogram_atan2(im, re)) + pi) * scale, last) + check;
+      }
+    });
+  }
+
+  void merge(const phase_histogram& other) {
+    if (other.bins() != bins()) {
+      throw std::invalid_argument("phase_histogram: cannot merge histograms with different bins");
+    }
+    for (int64_t k = 0; k < bins(); k++) {
+      counts_[k] += other.counts_[k];
+    }
+    discarded_ += other.discarded_;
+  }
+
+  int64_t bins() const {
+    return static_cast<int64_t>(counts_.size());
+  }
+
+  // lower edge of bin k, from -pi to bin_edge(bins()) = pi
+  T bin_edge(int64_t k) const {
+    return static_cast<T>(detail::histogram_pi) * (T(2) * static_cast<T>(k) / static_cast<T>(bins()) - T(1));
+  }
+
+  const std::vector<int64_t>& counts() const {
+    return counts_;
+  }
+
+  int64_t discarded() const {
+    return discarded_;
+  }
+
+ private:
+  std::vector<int64_t> counts_;
+  int64_t discarded_ = 0;
+};
+
+// explicit instantiations, see [Header layout] in c10/util/complex_core.h
+#define C10_COMPLEX_STATS_INSTANTIATE(prefix, T) \
+  prefix template class moments<T>; \
+  prefix template class cross_moments<T>; \
+  prefix template class magnitude_histogram<T>; \
+  prefix template class phase_histogram<T>;
+
+#ifdef C10_COMPLEX_EXTERN_TEMPLATES_ENABLED
+C10_COMPLEX_STATS_INSTANTIATE(extern, float)
+C10_COMPLEX_STATS_INSTANTIATE(extern, double)
+#endif
+
+} // namespace c10
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <c10/util/complex.h>
+#include <c10/util/complex_fft.h>
+#include <c10/util/parallel.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// [Short-time Fourier transform]
+//
+// stft<T> computes the STFT of a real or complex signal with a precomputed window table and a
+// power of two frame length n_fft = window.size(). Frame f covers the input samples
+// [f * hop, f * hop + n_fft), and only frames that fit entirely in the input are computed, so
+// there are num_frames(length) = 1 + (length - n_fft) / hop frames (0 if length < n_fft).
+//
+// Framing, windowing and the bit reversal pass of the FFT are a single pass: every frame is read
+// directly from the input through the window, without copying the overlapping samples into a
+// frame buffer first. magnitude_phase additionally computes |X| and arg(X) while the spectrum of
+// a frame is still in cache, so that the complex spectrogram is never written to memory.
+//
+// Output is row-major frames x bins, where bins is n_fft for complex input and n_fft / 2 + 1
+// (the non-negative frequencies) for real input. Real input is transformed two frames at a time,
+// packed in the real and imaginary parts of one complex FFT.
+//
+// inverse is the overlap-add inverse of forward for complex input, normalized by the sum of the
+// squared windows, so that inverse(forward(x)) = x wherever the window sum is nonzero.
+//
+// Frames are split across threads.
+
+namespace c10 {
+
+// Periodic window tables, the same as torch.hann_window/blackman_window/kaiser_window
+template<typename T>
+std::vector<T> hann_window(int64_t n) {
+  std::vector<T> w(n);
+  for (int64_t k = 0; k < n; k++) {
+    w[k] = static_cast<T>(0.5 - 0.5 * std::cos(6.283185307179586476925 * k / n));
+  }
+  return w;
+}
+
+template<typename T>
+std::vector<T> blackman_window(int64_t n) {
+  std::vector<T> w(n);
+  for (int64_t k = 0; k < n; k++) {
+    const double x = 6.283185307179586476925 * k / n;
+    w[k] = static_cast<T>(0.42 - 0.5 * std::cos(x) + 0.08 * std::cos(2 * x));
+  }
+  return w;
+}
+
+namespace detail {
+
+// modified Bessel function of the first kind of order 0, by its power series
+inline double bessel_i0(double x) {
+  double sum = 1.0;
+  double term = 1.0;
+  const double y = x * x / 4;
+  for (int k = 1; term > 1e-17 * sum; k++) {
+    term *= y / (static_cast<double>(k) * k);
+    sum += term;
+  }
+  return sum;
+}
+
+} // namespace detail
+
+template<typename T>
+std::vector<T> kaiser_window(int64_t n, double beta = 12.0) {
+  std::vector<T> w(n);
+  const double scale = 1.0 / detail::bessel_i0(beta);
+  for (int64_t k = 0; k < n; k++) {
+    // symmetric window of length n + 1 without its last sample
+    const double r = 2.0 * k / n - 1.0;
+    w[k] = static_cast<T>(detail::bessel_i0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) * scale);
+  }
+  return w;
+}
+
+template<typename T>
+class stft {
+ public:
+  stft(std::vector<T> window, int64_t hop)
+    : window_(std::move(window)), hop_(hop),
+      forward_(static_cast<int64_t>(window_.size())), inverse_(static_cast<int64_t>(window_.size()), true) {
+    if (hop <= 0) {
+      throw std::invalid_argument("stft: hop must be positive");
+    }
+  }
+
+  int64_t n_fft() const {
+    return forward_.size();
+  }
+
+  int64_t hop() const {
+    return hop_;
+  }
+
+  int64_t onesided_bins() const {
+    return n_fft() / 2 + 1;
+  }
+
+  int64_t num_frames(int64_t length) const {
+    return length < n_fft() ? 0 : 1 + (length - n_fft()) / hop_;
+  }
+
+  // out: num_frames(length) x n_fft
+  void forward(const complex<T>* in, int64_t length, complex<T>* out) const {
+    C10_COMPLEX_KERNEL("c10::stft::forward");
+    const int64_t n = n_fft();
+    parallel_for(0, num_frames(length), 1, [&](int64_t begin, int64_t end) {
+      for (int64_t f = begin; f < end; f++) {
+        transform_frame(in + f * hop_, out + f * n);
+      }
+    });
+  }
+
+  // out: num_frames(length) x onesided_bins()
+  void forward(const T* in, int64_t length, complex<T>* out) const {
+    C10_COMPLEX_KERNEL("c10::stft::forward");
+    const int64_t bins = onesided_bins();
+    for_each_real_frame_pair(in, length, [&](int64_t f, const complex<T>* x) {
+      std::copy(x, x + bins, out + f * bins);
+    });
+  }
+
+  // magnitude, phase: num_frames(length) x n_fft
+  void magnitude_phase(const complex<T>* in, int64_t length, T* magnitude, T* phase) const {
+    C10_COMPLEX_KERNEL("c10::stft::magnitude_phase");
+    const int64_t n = n_fft();
+    parallel_for(0, num_frames(length), 1, [&](int64_t begin, int64_t end) {
+      std::vector<complex<T>> scratch(n);
+      for (int64_t f = begin; f < end; f++) {
+        transform_frame(in + f * hop_, scratch.data());
+        for (int64_t k = 0; k < n; k++) {
+          magnitude[f * n + k] = std::abs(scratch[k]);
+          phase[f * n + k] = std::arg(scratch[k]);
+        }
+      }
+    });
+  }
+
+  // magnitude, phase: num_frames(length) x onesided_bins()
+  void magnitude_phase(const T* in, int64_t length, T* magnitude, T* phase) const {
+    C10_COMPLEX_KERNEL("c10::stft::magnitude_phase");
+    const int64_t bins = onesided_bins();
+    for_each_real_frame_pair(in, length, [&](int64_t f, const complex<T>* x) {
+      for (int64_t k = 0; k < bins; k++) {
+        magnitude[f * bins + k] = std::abs(x[k]);
+        phase[f * bins + k] = std::arg(x[k]);
+      }
+    });
+  }
+
+  // spectrum: frames x n_fft, out: (frames - 1) * hop + n_fft samples
+  void inverse(const complex<T>* spectrum, int64_t frames, complex<T>* out) const {
+    C10_COMPLEX_KERNEL("c10::stft::inverse");
+    if (frames <= 0) {
+      return;
+    }
+    const int64_t n = n_fft();
+    const int64_t length = (frames - 1) * hop_ + n;
+    std::vector<complex<T>> frames_time(frames * n);
+    parallel_for(0, frames, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t f = begin; f < end; f++) {
+        inverse_.execute(spectrum + f * n, frames_time.data() + f * n);
+      }
+    });
+    std::vector<T> window_sum(length, T(0));
+    std::fill(out, out + length, complex<T>());
+    const T scale = T(1) / static_cast<T>(n);
+    for (int64_t f = 0; f < frames; f++) {
+      complex<T>* y = out + f * hop_;
+      T* wsum = window_sum.data() + f * hop_;
+      const complex<T>* x = frames_time.data() + f * n;
+      for (int64_t j = 0; j < n; j++) {
+        y[j] += x[j] * (window_[j] * scale);
+        wsum[j] += window_[j] * window_[j];
+      }
+    }
+    for (int64_t t = 0; t < length; t++) {
+      if (window_sum[t] > T(1e-11)) {
+        out[t] /= window_sum[t];
+      }
+    }
+  }
+
+ private:
+  void transform_frame(const complex<T>* frame, complex<T>* out) const {
+    const T* w = window_.data();
+    forward_.execute_from([frame, w](int64_t j) { return frame[j] * w[j]; }, out);
+  }
+
+  // Transforms real frames f and f + 1 with one complex FFT of x_f + i x_{f+1}, and calls
+  // sink(f, X_f) and sink(f + 1, X_{f+1}) with the first onesided_bins() bins of each spectrum.
+  template<typename F>
+  void for_each_real_frame_pair(const T* in, int64_t length, const F& sink) const {
+    const int64_t n = n_fft();
+    const int64_t frames = num_frames(length);
+    parallel_for(0, divup(frames, 2), 1, [&](int64_t begin, int64_t end) {
+      std::vector<complex<T>> packed(n);
+      std::vector<complex<T>> first(n / 2 + 1);
+      std::vector<complex<T>> second(n / 2 + 1);
+      const T* w = window_.data();
+      for (int64_t p = begin; p < end; p++) {
+        const int64_t f = 2 * p;
+        const T* x0 = in + f * hop_;
+        const bool has_second = f + 1 < frames;
+        if (has_second) {
+          const T* x1 = x0 + hop_;
+          forward_.execute_from([x0, x1, w](int64_t j) { return complex<T>(x0[j] * w[j], x1[j] * w[j]); }, packed.data());
+        } else {
+          forward_.execute_from([x0, w](int64_t j) { return complex<T>(x0[j] * w[j], T(0)); }, packed.data());
+        }
+        // X_f[k] = (Z[k] + conj(Z[n - k])) / 2, X_{f+1}[k] = (Z[k] - conj(Z[n - k])) / 2i
+        for (int64_t k = 0; k <= n / 2; k++) {
+          const complex<T> z = packed[k];
+          const complex<T> zc = std::conj(packed[(n - k) & (n - 1)]);
+          const complex<T> sum = z + zc;
+          const complex<T> diff = z - zc;
+          first[k] = complex<T>(sum.real() / 2, sum.imag() / 2);
+          second[k] = complex<T>(diff.imag() / 2, -diff.real() / 2);
+        }
+        sink(f, first.data());
+        if (has_second) {
+          sink(f + 1, second.data());
+        }
+      }
+    });
+  }
+
+  std::vector<T> window_;
+  int64_t hop_;
+  fft_plan<T> forward_;
+  fft_plan<T> inverse_;
+};
+
+// explicit instantiations, see [Header layout] in c10/util/complex_core.h
+#define C10_COMPLEX_STFT_INSTANTIATE(prefix, T) \
+  prefix template std::vector<T> hann_window<T>(int64_t); \
+  prefix template std::vector<T> blackman_window<T>(int64_t); \
+  prefix template std::vector<T> kaiser_window<T>(int64_t, double); \
+  prefix template class stft<T>;
+
+#ifdef C10_COMPLEX_EXTERN_TEMPLATES_ENABLED
+C10_COMPLEX_STFT_INSTANTIATE(extern, float)
+C10_COMPLEX_STFT_INSTANTIATE(extern, double)
+#endif
+
+} // namespace c10
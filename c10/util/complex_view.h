@@ -0,0 +1,106 @@
+#pragma once
+
+#include <c10/util/complex.h>
+#include <cassert>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// [Zero-copy views]
+//
+// c10::complex<T> has the same layout as std::complex<T> and as T[2]: real part first,
+// imaginary part second, no padding. So a buffer of n complex numbers can be passed to code
+// expecting std::complex<T>[n] or interleaved T[2n] without copying, and back:
+//
+//   view_as_real(complex<T>*)         -> T*                  (2n elements)
+//   view_as_complex(T*)               -> complex<T>*         (n elements from 2n)
+//   view_as_std(complex<T>*)          -> std::complex<T>*
+//   view_as_c10(std::complex<T>*)     -> complex<T>*
+//
+// The names follow torch.view_as_real/torch.view_as_complex. The layout is checked at compile
+// time. c10::complex<T> is aligned to 2 * sizeof(T), which is stricter than T and std::complex<T>,
+// so view_as_complex and view_as_c10 assert at runtime that the pointer is suitably aligned.
+
+namespace c10 {
+
+namespace detail {
+
+template<typename T>
+struct check_complex_layout {
+  static_assert(std::is_standard_layout<complex<T>>::value, "c10::complex must be standard layout");
+  static_assert(sizeof(complex<T>) == 2 * sizeof(T), "c10::complex must have no padding");
+  static_assert(alignof(complex<T>) % alignof(T) == 0, "c10::complex must be at least as aligned as T");
+  static constexpr bool value = true;
+};
+
+template<typename T>
+struct check_std_complex_layout {
+  static_assert(std::is_floating_point<T>::value, "std::complex is only specified for floating point types");
+  static_assert(check_complex_layout<T>::value, "");
+  static_assert(sizeof(complex<T>) == sizeof(std::complex<T>), "c10::complex and std::complex must have the same size");
+  static_assert(alignof(complex<T>) % alignof(std::complex<T>) == 0,
+                "c10::complex must be at least as aligned as std::complex");
+  static constexpr bool value = true;
+};
+
+template<typename T>
+C10_HOST_DEVICE bool is_complex_aligned(const void* ptr) {
+  return reinterpret_cast<std::uintptr_t>(ptr) % alignof(complex<T>) == 0;
+}
+
+} // namespace detail
+
+template<typename T>
+C10_HOST_DEVICE T* view_as_real(complex<T>* data) {
+  static_assert(detail::check_complex_layout<T>::value, "");
+  return reinterpret_cast<T*>(data);
+}
+
+template<typename T>
+C10_HOST_DEVICE const T* view_as_real(const complex<T>* data) {
+  static_assert(detail::check_complex_layout<T>::value, "");
+  return reinterpret_cast<const T*>(data);
+}
+
+template<typename T>
+C10_HOST_DEVICE complex<T>* view_as_complex(T* data) {
+  static_assert(detail::check_complex_layout<T>::value, "");
+  assert(detail::is_complex_aligned<T>(data));
+  return reinterpret_cast<complex<T>*>(data);
+}
+
+template<typename T>
+C10_HOST_DEVICE const complex<T>* view_as_complex(const T* data) {
+  static_assert(detail::check_complex_layout<T>::value, "");
+  assert(detail::is_complex_aligned<T>(data));
+  return reinterpret_cast<const complex<T>*>(data);
+}
+
+template<typename T>
+C10_HOST_DEVICE std::complex<T>* view_as_std(complex<T>* data) {
+  static_assert(detail::check_std_complex_layout<T>::value, "");
+  return reinterpret_cast<std::complex<T>*>(data);
+}
+
+template<typename T>
+C10_HOST_DEVICE const std::complex<T>* view_as_std(const complex<T>* data) {
+  static_assert(detail::check_std_complex_layout<T>::value, "");
+  return reinterpret_cast<const std::complex<T>*>(data);
+}
+
+template<typename T>
+C10_HOST_DEVICE complex<T>* view_as_c10(std::complex<T>* data) {
+  static_assert(detail::check_std_complex_layout<T>::value, "");
+  assert(detail::is_complex_aligned<T>(data));
+  return reinterpret_cast<complex<T>*>(data);
+}
+
+template<typename T>
+C10_HOST_DEVICE const complex<T>* view_as_c10(const std::complex<T>* data) {
+  static_assert(detail::check_std_complex_layout<T>::value, "");
+  assert(detail::is_complex_aligned<T>(data));
+  return reinterpret_cast<const complex<T>*>(data);
+}
+
+} // namespace c10
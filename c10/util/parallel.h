@@ -0,0 +1,76 @@
+#pragma once
+
+#include <c10/util/complex_instrumentation.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace c10 {
+
+// A minimal stand-in for at::parallel_for, used by the batched complex kernels.
+//
+// parallel_for splits [begin, end) into at most get_num_threads() contiguous chunks of
+// at least grain_size elements, and calls f(chunk_begin, chunk_end) once per chunk.
+// The first chunk runs on the calling thread. f must not throw.
+//
+// Kernels whose result depends on how the range is split (e.g. floating point reductions)
+// should split by a fixed block size and parallelize over blocks, so that the result does
+// not depend on the number of threads.
+
+namespace detail {
+
+inline std::atomic<int>& num_threads() {
+  static std::atomic<int> value{0};
+  return value;
+}
+
+} // namespace detail
+
+inline int get_num_threads() {
+  int n = detail::num_threads().load();
+  if (n > 0) {
+    return n;
+  }
+  return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+// n <= 0 restores the default, which is the number of hardware threads
+inline void set_num_threads(int n) {
+  detail::num_threads().store(n);
+}
+
+inline int64_t divup(int64_t x, int64_t y) {
+  return (x + y - 1) / y;
+}
+
+template<typename F>
+void parallel_for(int64_t begin, int64_t end, int64_t grain_size, const F& f) {
+  if (begin >= end) {
+    return;
+  }
+  int64_t num_chunks = std::min<int64_t>(get_num_threads(), divup(end - begin, std::max<int64_t>(grain_size, 1)));
+  if (num_chunks <= 1) {
+    f(begin, end);
+    return;
+  }
+  int64_t chunk_size = divup(end - begin, num_chunks);
+  std::vector<std::thread> threads;
+  threads.reserve(num_chunks - 1);
+  // the kernel scope of the caller, which the workers inherit and report their flops to
+  auto kernel = C10_COMPLEX_CURRENT_KERNEL();
+  for (int64_t chunk_begin = begin + chunk_size; chunk_begin < end; chunk_begin += chunk_size) {
+    int64_t chunk_end = std::min(chunk_begin + chunk_size, end);
+    threads.emplace_back([&f, kernel, chunk_begin, chunk_end]() {
+      C10_COMPLEX_INHERIT_KERNEL(kernel);
+      f(chunk_begin, chunk_end);
+    });
+  }
+  f(begin, begin + chunk_size);
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+} // namespace c10